@@ -124,6 +124,10 @@ void perfCipher(BlockCipher *cipher, const struct TestVector *test)
     elapsed = micros() - start;
     Serial.print(elapsed / (5000.0 * 16.0));
     Serial.print("us per byte, ");
+#ifdef F_CPU
+    Serial.print(elapsed * (F_CPU / 1000000.0) / (5000.0 * 16.0));
+    Serial.print(" cycles per byte, ");
+#endif
     Serial.print((16.0 * 5000.0 * 1000000.0) / elapsed);
     Serial.println(" bytes per second");
 
@@ -136,6 +140,10 @@ void perfCipher(BlockCipher *cipher, const struct TestVector *test)
     elapsed = micros() - start;
     Serial.print(elapsed / (5000.0 * 16.0));
     Serial.print("us per byte, ");
+#ifdef F_CPU
+    Serial.print(elapsed * (F_CPU / 1000000.0) / (5000.0 * 16.0));
+    Serial.print(" cycles per byte, ");
+#endif
     Serial.print((16.0 * 5000.0 * 1000000.0) / elapsed);
     Serial.println(" bytes per second");
 
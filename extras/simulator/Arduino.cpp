@@ -0,0 +1,107 @@
+/*
+  This file is part of the ArduinoECCX08 library.
+  Copyright (c) 2026 Operator Foundation. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "Arduino.h"
+
+#include <ctype.h>
+#include <stdio.h>
+
+static unsigned long currentMicros = 0;
+
+unsigned long millis()
+{
+  return currentMicros / 1000;
+}
+
+unsigned long micros()
+{
+  return currentMicros;
+}
+
+void delay(unsigned long ms)
+{
+  currentMicros += ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  currentMicros += us;
+}
+
+void advanceMicros(unsigned long us)
+{
+  currentMicros += us;
+}
+
+String::String(const char* str) :
+  _buffer(str ? str : "")
+{
+}
+
+String::String(unsigned char value, unsigned char base) :
+  String((int)value, base)
+{
+}
+
+String::String(int value, unsigned char base)
+{
+  char buffer[16];
+
+  snprintf(buffer, sizeof(buffer), (base == HEX) ? "%x" : "%d", value);
+  _buffer = buffer;
+}
+
+void String::reserve(unsigned int size)
+{
+  _buffer.reserve(size);
+}
+
+unsigned int String::length() const
+{
+  return _buffer.length();
+}
+
+const char* String::c_str() const
+{
+  return _buffer.c_str();
+}
+
+String& String::operator+=(const char* str)
+{
+  _buffer += str;
+  return *this;
+}
+
+String& String::operator+=(const String& str)
+{
+  _buffer += str._buffer;
+  return *this;
+}
+
+bool String::operator==(const char* str) const
+{
+  return _buffer == str;
+}
+
+void String::toUpperCase()
+{
+  for (size_t i = 0; i < _buffer.length(); i++) {
+    _buffer[i] = toupper(_buffer[i]);
+  }
+}
@@ -0,0 +1,72 @@
+/*
+  This file is part of the ArduinoECCX08 library.
+  Copyright (c) 2026 Operator Foundation. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+// Minimal stand-in for the Arduino core so the library sources build on a
+// Linux host.  Time is virtual: it only moves when the code under test
+// delays or when a bus transfer is charged to it, which keeps simulated
+// latencies deterministic.
+
+#ifndef _SIMULATOR_ARDUINO_H_
+#define _SIMULATOR_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+
+typedef uint8_t byte;
+
+#define DEC 10
+#define HEX 16
+
+using std::min;
+using std::max;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// host only, moves the virtual clock forward
+void advanceMicros(unsigned long us);
+
+class String
+{
+public:
+  String(const char* str = "");
+  String(unsigned char value, unsigned char base = DEC);
+  String(int value, unsigned char base = DEC);
+
+  void reserve(unsigned int size);
+  unsigned int length() const;
+  const char* c_str() const;
+
+  String& operator+=(const char* str);
+  String& operator+=(const String& str);
+  bool operator==(const char* str) const;
+
+  void toUpperCase();
+
+private:
+  std::string _buffer;
+};
+
+#endif
@@ -0,0 +1,833 @@
+/*
+  This file is part of the ArduinoECCX08 library.
+  Copyright (c) 2026 Operator Foundation. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "ECCX08Simulator.h"
+
+// status codes returned in a 4 byte response
+enum {
+  STATUS_SUCCESS   = 0x00,
+  STATUS_MISCOMPARE = 0x01,
+  STATUS_PARSE     = 0x03,
+  STATUS_EXECUTION = 0x0f,
+  STATUS_WAKE      = 0x11,
+  STATUS_CRC       = 0xff
+};
+
+// time the device needs after the wake pulse before it answers
+static const unsigned long wakeHighTime = 1500;
+
+// shortest SDA low time that is recognised as a wake pulse
+static const unsigned long wakeLowTime = 60;
+
+// toy group used in place of P-256, see ECCX08Simulator.h
+static const uint64_t groupPrime = (1ULL << 61) - 1;
+static const uint64_t groupGenerator = 37;
+
+static const struct {
+  uint8_t opcode;
+  unsigned long us[2]; // ATECC508A, ATECC608A
+} defaultExecutionTimes[] = {
+  { 0x02, {   400,   800 } }, // Read
+  { 0x12, {  7000,  7000 } }, // Write
+  { 0x16, {   400,   400 } }, // Nonce
+  { 0x17, {  8000,  8000 } }, // Lock
+  { 0x1b, {  1500,  1500 } }, // Random
+  { 0x30, {   200,   200 } }, // Info
+  { 0x40, { 60000, 60000 } }, // GenKey
+  { 0x41, { 42000, 38000 } }, // Sign
+  { 0x43, { 38000, 38000 } }, // ECDH
+  { 0x45, { 50000, 55000 } }, // Verify
+  { 0x47, {  7000,   600 } }, // SHA
+  { 0x51, {     0,   400 } }, // AES
+};
+
+static uint64_t mulMod(uint64_t a, uint64_t b, uint64_t m)
+{
+  return (unsigned __int128)a * b % m;
+}
+
+static uint64_t powMod(uint64_t base, uint64_t exponent)
+{
+  uint64_t result = 1;
+
+  base %= groupPrime;
+
+  while (exponent) {
+    if (exponent & 1) {
+      result = mulMod(result, base, groupPrime);
+    }
+
+    base = mulMod(base, base, groupPrime);
+    exponent >>= 1;
+  }
+
+  return result;
+}
+
+static uint64_t hashToExponent(const uint8_t data[], size_t length)
+{
+  uint8_t digest[32];
+  uint64_t result = 0;
+
+  simSha256(data, length, digest);
+
+  for (int i = 0; i < 8; i++) {
+    result = (result << 8) | digest[i];
+  }
+
+  return result % (groupPrime - 1);
+}
+
+static void encodeScalar(uint64_t value, uint8_t out[32])
+{
+  memset(out, 0, 32);
+
+  for (int i = 0; i < 8; i++) {
+    out[31 - i] = value >> (i * 8);
+  }
+}
+
+static uint64_t decodeScalar(const uint8_t in[32])
+{
+  uint64_t value = 0;
+
+  for (int i = 24; i < 32; i++) {
+    value = (value << 8) | in[i];
+  }
+
+  return value;
+}
+
+static void encodePublicKey(uint64_t value, uint8_t out[64])
+{
+  encodeScalar(value, out);
+
+  // filler so the Y half is not all zeros
+  simSha256(out, 32, &out[32]);
+}
+
+ECCX08Simulator::ECCX08Simulator(Revision revision, uint8_t address) :
+  _revision(revision),
+  _address(address),
+  _watchdogTimeout(1300000),
+  _state(STATE_SLEEP),
+  _wakeTime(0),
+  _readyTime(0),
+  _randomState(0x0123456789abcdefULL),
+  _tempKeyValid(false),
+  _shaActive(false),
+  _outputLength(0),
+  _outputOffset(0)
+{
+  for (int i = 0; i < 256; i++) {
+    _executionTimes[i] = 1000;
+  }
+
+  for (size_t i = 0; i < sizeof(defaultExecutionTimes) / sizeof(defaultExecutionTimes[0]); i++) {
+    _executionTimes[defaultExecutionTimes[i].opcode] = defaultExecutionTimes[i].us[revision];
+  }
+
+  memset(_config, 0x00, sizeof(_config));
+  memset(_otp, 0xff, sizeof(_otp));
+  memset(_slots, 0x00, sizeof(_slots));
+
+  static const uint8_t serialNumber[9] = { 0x01, 0x23, 0x5e, 0x6a, 0x72, 0x10, 0x4c, 0x91, 0xee };
+
+  memcpy(&_config[0], &serialNumber[0], 4);
+  memcpy(&_config[8], &serialNumber[4], 5);
+
+  // RevNum, 00 00 50 00 or 00 00 60 02
+  _config[6] = (revision == ATECC608A) ? 0x60 : 0x50;
+  _config[7] = (revision == ATECC608A) ? 0x02 : 0x00;
+
+  _config[14] = 0xc0; // I2C enable
+  _config[16] = address << 1;
+
+  // LockValue and LockConfig, unlocked
+  _config[86] = 0x55;
+  _config[87] = 0x55;
+
+  resetStats();
+}
+
+ECCX08Simulator::Revision ECCX08Simulator::revision() const
+{
+  return _revision;
+}
+
+void ECCX08Simulator::setExecutionTime(uint8_t opcode, unsigned long us)
+{
+  _executionTimes[opcode] = us;
+}
+
+unsigned long ECCX08Simulator::executionTime(uint8_t opcode) const
+{
+  return _executionTimes[opcode];
+}
+
+void ECCX08Simulator::setWatchdogTimeout(unsigned long us)
+{
+  _watchdogTimeout = us;
+}
+
+void ECCX08Simulator::setRandomSeed(uint64_t seed)
+{
+  _randomState = seed;
+}
+
+void ECCX08Simulator::setSlot(int slot, const byte data[], size_t length)
+{
+  if (slot < 0 || slot > 15 || length > sizeof(_slots[0])) {
+    return;
+  }
+
+  memcpy(_slots[slot], data, length);
+}
+
+void ECCX08Simulator::setLocked(bool configLocked, bool dataLocked)
+{
+  _config[87] = configLocked ? 0x00 : 0x55;
+  _config[86] = dataLocked ? 0x00 : 0x55;
+}
+
+const ECCX08Simulator::Stats& ECCX08Simulator::stats() const
+{
+  return _stats;
+}
+
+void ECCX08Simulator::resetStats()
+{
+  memset(&_stats, 0x00, sizeof(_stats));
+}
+
+int ECCX08Simulator::busWrite(uint8_t address, const uint8_t data[], size_t length, uint32_t frequency)
+{
+  checkWatchdog();
+
+  if (address == 0x00) {
+    // SDA held low for the address byte, long enough to count as a wake
+    // pulse only at a slow enough clock
+    if (_state != STATE_ACTIVE && (8 * 1000000UL / frequency) >= wakeLowTime) {
+      if (_state == STATE_SLEEP) {
+        clearVolatile();
+      }
+
+      _state = STATE_ACTIVE;
+      _wakeTime = micros();
+      _readyTime = _wakeTime + wakeHighTime;
+      respondStatus(STATUS_WAKE);
+      _stats.wakes++;
+    }
+
+    // nobody answers to the general call address
+    return 2;
+  }
+
+  if (address != _address || _state != STATE_ACTIVE || (long)(micros() - _readyTime) < 0) {
+    _stats.nacks++;
+    return 2;
+  }
+
+  _stats.bytesWritten += length;
+
+  if (length == 0) {
+    return 0;
+  }
+
+  switch (data[0]) {
+    case 0x00: // reset the address counter
+      _outputOffset = 0;
+      break;
+
+    case 0x01: // sleep
+      _state = STATE_SLEEP;
+      clearVolatile();
+      _stats.sleeps++;
+      break;
+
+    case 0x02: // idle
+      _state = STATE_IDLE;
+      _stats.idles++;
+      break;
+
+    case 0x03: // command
+      execute(&data[1], length - 1);
+      break;
+
+    default:
+      return 3;
+  }
+
+  return 0;
+}
+
+size_t ECCX08Simulator::busRead(uint8_t address, uint8_t data[], size_t length)
+{
+  checkWatchdog();
+
+  if (address != _address || _state != STATE_ACTIVE || (long)(micros() - _readyTime) < 0) {
+    _stats.nacks++;
+    return 0;
+  }
+
+  // reads carry on from where the last one stopped, past the end of the
+  // response the bus just reads back high
+  for (size_t i = 0; i < length; i++) {
+    data[i] = (_outputOffset < _outputLength) ? _output[_outputOffset++] : 0xff;
+  }
+
+  _stats.bytesRead += length;
+
+  return length;
+}
+
+unsigned long ECCX08Simulator::transferTime(size_t length, uint32_t frequency)
+{
+  // start, address and data bytes at 9 clocks each (8 bits + ACK), stop
+  unsigned long clocks = 1 + (1 + length) * 9 + 1;
+
+  return (clocks * 1000000UL + frequency - 1) / frequency;
+}
+
+void ECCX08Simulator::checkWatchdog()
+{
+  if (_state == STATE_ACTIVE && (micros() - _wakeTime) >= _watchdogTimeout) {
+    _state = STATE_SLEEP;
+    clearVolatile();
+    _stats.watchdogSleeps++;
+  }
+}
+
+void ECCX08Simulator::clearVolatile()
+{
+  memset(_tempKey, 0x00, sizeof(_tempKey));
+  _tempKeyValid = false;
+  _shaActive = false;
+  _outputLength = 0;
+  _outputOffset = 0;
+}
+
+void ECCX08Simulator::execute(const uint8_t packet[], size_t length)
+{
+  _stats.commands++;
+
+  if (length < 7 || packet[0] != length) {
+    _readyTime = micros();
+    respondStatus(STATUS_CRC);
+    return;
+  }
+
+  uint16_t crc = packet[length - 2] | (packet[length - 1] << 8);
+
+  if (crc != simCrc16(packet, length - 2)) {
+    _readyTime = micros();
+    respondStatus(STATUS_CRC);
+    return;
+  }
+
+  uint8_t opcode = packet[1];
+  uint8_t param1 = packet[2];
+  uint16_t param2 = packet[3] | (packet[4] << 8);
+  const uint8_t* data = &packet[5];
+  size_t dataLength = length - 7;
+
+  _readyTime = micros() + _executionTimes[opcode];
+
+  switch (opcode) {
+    case 0x02:
+      read(param1, param2);
+      break;
+
+    case 0x12:
+      write(param1, param2, data, dataLength);
+      break;
+
+    case 0x16:
+      nonce(param1, data, dataLength);
+      break;
+
+    case 0x17:
+      lock(param1);
+      break;
+
+    case 0x1b:
+      random();
+      break;
+
+    case 0x30:
+      info(param1);
+      break;
+
+    case 0x40:
+      genKey(param1, param2);
+      break;
+
+    case 0x41:
+      sign(param1, param2);
+      break;
+
+    case 0x43:
+      ecdh(param1, param2, data, dataLength);
+      break;
+
+    case 0x45:
+      verify(param1, data, dataLength);
+      break;
+
+    case 0x47:
+      sha(param1, param2, data, dataLength);
+      break;
+
+    case 0x51:
+      if (_revision == ATECC608A) {
+        aes(param1, param2, data, dataLength);
+        break;
+      }
+      // the ATECC508A has no AES command
+      // fall through
+
+    default:
+      _readyTime = micros();
+      respondStatus(STATUS_PARSE);
+      break;
+  }
+}
+
+void ECCX08Simulator::respond(const uint8_t data[], size_t length)
+{
+  _outputLength = length + 3;
+  _outputOffset = 0;
+  _output[0] = _outputLength;
+  memcpy(&_output[1], data, length);
+
+  uint16_t crc = simCrc16(_output, length + 1);
+
+  _output[length + 1] = crc & 0xff;
+  _output[length + 2] = crc >> 8;
+}
+
+void ECCX08Simulator::respondStatus(uint8_t status)
+{
+  respond(&status, 1);
+}
+
+uint8_t* ECCX08Simulator::zoneAddress(uint8_t zone, uint16_t address, size_t length)
+{
+  switch (zone & 0x03) {
+    case 0: {
+      size_t offset = (address & 0x1f) * 4;
+
+      return (offset + length <= sizeof(_config)) ? &_config[offset] : NULL;
+    }
+
+    case 1: {
+      size_t offset = (address & 0x0f) * 4;
+
+      return (offset + length <= sizeof(_otp)) ? &_otp[offset] : NULL;
+    }
+
+    case 2: {
+      int slot = (address >> 3) & 0x0f;
+      size_t offset = (address >> 8) * 32 + (address & 0x07) * 4;
+
+      return (offset + length <= sizeof(_slots[0])) ? &_slots[slot][offset] : NULL;
+    }
+
+    default:
+      return NULL;
+  }
+}
+
+void ECCX08Simulator::read(uint8_t zone, uint16_t address)
+{
+  size_t length = (zone & 0x80) ? 32 : 4;
+  uint8_t* source = zoneAddress(zone, address, length);
+
+  if (source == NULL) {
+    respondStatus(STATUS_PARSE);
+    return;
+  }
+
+  respond(source, length);
+}
+
+void ECCX08Simulator::write(uint8_t zone, uint16_t address, const uint8_t data[], size_t length)
+{
+  if (length != ((zone & 0x80) ? 32 : 4)) {
+    respondStatus(STATUS_PARSE);
+    return;
+  }
+
+  uint8_t* target = zoneAddress(zone, address, length);
+
+  if (target == NULL) {
+    respondStatus(STATUS_PARSE);
+    return;
+  }
+
+  if ((zone & 0x03) == 0) {
+    size_t offset = target - _config;
+
+    // the first 16 bytes and the lock bytes cannot be written, and nothing
+    // in the zone can once it is locked
+    if (_config[87] != 0x55 || offset < 16 || (offset < 88 && offset + length > 84)) {
+      respondStatus(STATUS_EXECUTION);
+      return;
+    }
+  }
+
+  memcpy(target, data, length);
+  respondStatus(STATUS_SUCCESS);
+}
+
+void ECCX08Simulator::lock(uint8_t mode)
+{
+  // LockConfig is byte 87, LockValue (data and OTP) is byte 86
+  uint8_t* lockByte = (mode & 0x01) ? &_config[86] : &_config[87];
+
+  if (*lockByte != 0x55 || ((mode & 0x01) && _config[87] != 0x00)) {
+    respondStatus(STATUS_EXECUTION);
+    return;
+  }
+
+  *lockByte = 0x00;
+  respondStatus(STATUS_SUCCESS);
+}
+
+void ECCX08Simulator::random()
+{
+  uint8_t output[32];
+
+  for (int i = 0; i < 32; i += 8) {
+    uint64_t value = nextRandom();
+
+    memcpy(&output[i], &value, 8);
+  }
+
+  respond(output, sizeof(output));
+}
+
+void ECCX08Simulator::nonce(uint8_t mode, const uint8_t data[], size_t length)
+{
+  if ((mode & 0x03) == 0x03) {
+    // pass through
+    if (length != 32) {
+      respondStatus(STATUS_PARSE);
+      return;
+    }
+
+    memcpy(_tempKey, data, 32);
+    _tempKeyValid = true;
+    respondStatus(STATUS_SUCCESS);
+    return;
+  }
+
+  if (length != 20) {
+    respondStatus(STATUS_PARSE);
+    return;
+  }
+
+  uint8_t message[55];
+  uint8_t randOut[32];
+
+  for (int i = 0; i < 32; i += 8) {
+    uint64_t value = nextRandom();
+
+    memcpy(&randOut[i], &value, 8);
+  }
+
+  memcpy(&message[0], randOut, 32);
+  memcpy(&message[32], data, 20);
+  message[52] = 0x16;
+  message[53] = mode;
+  message[54] = 0x00;
+
+  simSha256(message, sizeof(message), _tempKey);
+  _tempKeyValid = true;
+
+  respond(randOut, sizeof(randOut));
+}
+
+void ECCX08Simulator::info(uint8_t mode)
+{
+  if (mode != 0x00) {
+    respondStatus(STATUS_PARSE);
+    return;
+  }
+
+  respond(&_config[4], 4);
+}
+
+void ECCX08Simulator::genKey(uint8_t mode, uint16_t slot)
+{
+  if (slot > 15) {
+    respondStatus(STATUS_PARSE);
+    return;
+  }
+
+  uint64_t privateKey = decodeScalar(_slots[slot]);
+
+  if (mode & 0x04) {
+    privateKey = 2 + nextRandom() % (groupPrime - 3);
+    encodeScalar(privateKey, _slots[slot]);
+  } else if (privateKey == 0) {
+    respondStatus(STATUS_EXECUTION);
+    return;
+  }
+
+  uint8_t publicKey[64];
+
+  encodePublicKey(powMod(groupGenerator, privateKey), publicKey);
+  respond(publicKey, sizeof(publicKey));
+}
+
+void ECCX08Simulator::sign(uint8_t mode, uint16_t slot)
+{
+  uint64_t privateKey = (slot < 16) ? decodeScalar(_slots[slot]) : 0;
+
+  if (mode != 0x80 || !_tempKeyValid || privateKey == 0) {
+    respondStatus(STATUS_EXECUTION);
+    return;
+  }
+
+  uint8_t buffer[96];
+
+  // deterministic nonce from the key and message
+  encodeScalar(privateKey, &buffer[0]);
+  memcpy(&buffer[32], _tempKey, 32);
+
+  uint64_t k = hashToExponent(buffer, 64);
+  uint64_t r = powMod(groupGenerator, k);
+  uint64_t publicKey = powMod(groupGenerator, privateKey);
+
+  encodeScalar(r, &buffer[0]);
+  encodeScalar(publicKey, &buffer[32]);
+  memcpy(&buffer[64], _tempKey, 32);
+
+  uint64_t e = hashToExponent(buffer, 96);
+  uint64_t s = (k + mulMod(e, privateKey, groupPrime - 1)) % (groupPrime - 1);
+
+  uint8_t signature[64];
+
+  encodeScalar(r, &signature[0]);
+  encodeScalar(s, &signature[32]);
+
+  _tempKeyValid = false;
+
+  respond(signature, sizeof(signature));
+}
+
+void ECCX08Simulator::verify(uint8_t mode, const uint8_t data[], size_t length)
+{
+  if (mode != 0x02 || length != 128) {
+    respondStatus(STATUS_PARSE);
+    return;
+  }
+
+  if (!_tempKeyValid) {
+    respondStatus(STATUS_EXECUTION);
+    return;
+  }
+
+  uint64_t r = decodeScalar(&data[0]);
+  uint64_t s = decodeScalar(&data[32]);
+  uint64_t publicKey = decodeScalar(&data[64]);
+
+  uint8_t buffer[96];
+
+  encodeScalar(r, &buffer[0]);
+  encodeScalar(publicKey, &buffer[32]);
+  memcpy(&buffer[64], _tempKey, 32);
+
+  uint64_t e = hashToExponent(buffer, 96);
+
+  _tempKeyValid = false;
+
+  if (powMod(groupGenerator, s) != mulMod(r, powMod(publicKey, e), groupPrime)) {
+    respondStatus(STATUS_MISCOMPARE);
+    return;
+  }
+
+  respondStatus(STATUS_SUCCESS);
+}
+
+void ECCX08Simulator::ecdh(uint8_t mode, uint16_t slot, const uint8_t data[], size_t length)
+{
+  uint64_t privateKey = (slot < 16) ? decodeScalar(_slots[slot]) : 0;
+
+  if (length != 64) {
+    respondStatus(STATUS_PARSE);
+    return;
+  }
+
+  if (privateKey == 0) {
+    respondStatus(STATUS_EXECUTION);
+    return;
+  }
+
+  uint8_t secret[32];
+
+  encodeScalar(powMod(decodeScalar(data), privateKey), secret);
+  simSha256(secret, sizeof(secret), secret);
+
+  switch (mode & 0x0c) {
+    case 0x08: // clear text output
+      respond(secret, sizeof(secret));
+      return;
+
+    case 0x04: // TempKey
+      memcpy(_tempKey, secret, 32);
+      _tempKeyValid = true;
+      break;
+
+    default: // slot | 1
+      memcpy(_slots[slot | 1], secret, 32);
+      break;
+  }
+
+  respondStatus(STATUS_SUCCESS);
+}
+
+void ECCX08Simulator::sha(uint8_t mode, uint16_t length, const uint8_t data[], size_t dataLength)
+{
+  switch (mode & 0x07) {
+    case 0x00: // start
+      simSha256Init(_sha);
+      _shaActive = true;
+      respondStatus(STATUS_SUCCESS);
+      return;
+
+    case 0x01: // update, exactly one block
+      if (!_shaActive || dataLength != 64) {
+        respondStatus(_shaActive ? STATUS_PARSE : STATUS_EXECUTION);
+        return;
+      }
+
+      simSha256Update(_sha, data, dataLength);
+      respondStatus(STATUS_SUCCESS);
+      return;
+
+    case 0x02: { // end, up to 63 trailing bytes
+      if (!_shaActive || dataLength != length || dataLength > 63) {
+        respondStatus(_shaActive ? STATUS_PARSE : STATUS_EXECUTION);
+        return;
+      }
+
+      uint8_t digest[32];
+
+      simSha256Update(_sha, data, dataLength);
+      simSha256Final(_sha, digest);
+      _shaActive = false;
+
+      respond(digest, sizeof(digest));
+      return;
+    }
+
+    default:
+      respondStatus(STATUS_PARSE);
+      return;
+  }
+}
+
+void ECCX08Simulator::aes(uint8_t mode, uint16_t slot, const uint8_t data[], size_t length)
+{
+  uint8_t operation = mode & 0x07;
+  size_t expected = (operation == 0x03) ? 32 : 16;
+
+  if (length != expected || (slot > 15 && slot != 0xffff)) {
+    respondStatus(STATUS_PARSE);
+    return;
+  }
+
+  const uint8_t* key;
+
+  if (slot == 0xffff) {
+    if (!_tempKeyValid) {
+      respondStatus(STATUS_EXECUTION);
+      return;
+    }
+
+    key = &_tempKey[(mode & 0x40) ? 16 : 0];
+  } else {
+    key = &_slots[slot][(mode >> 6) * 16];
+  }
+
+  uint8_t output[16];
+
+  switch (operation) {
+    case 0x00:
+      simAes128Encrypt(key, data, output);
+      break;
+
+    case 0x01:
+      simAes128Decrypt(key, data, output);
+      break;
+
+    case 0x03: // GFM, H followed by the input
+      simGf128Multiply(&data[16], &data[0], output);
+      break;
+
+    default:
+      respondStatus(STATUS_PARSE);
+      return;
+  }
+
+  respond(output, sizeof(output));
+}
+
+uint64_t ECCX08Simulator::nextRandom()
+{
+  // splitmix64, deterministic so runs are reproducible
+  uint64_t z = (_randomState += 0x9e3779b97f4a7c15ULL);
+
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+
+  return z ^ (z >> 31);
+}
+
+ECCX08SimulatorTransport::ECCX08SimulatorTransport(ECCX08Simulator& simulator) :
+  _simulator(&simulator),
+  _frequency(100000)
+{
+}
+
+void ECCX08SimulatorTransport::setClock(uint32_t frequency)
+{
+  _frequency = frequency;
+}
+
+int ECCX08SimulatorTransport::write(uint8_t address, const byte data[], size_t length)
+{
+  int result = _simulator->busWrite(address, data, length, _frequency);
+
+  // a NACK ends the transfer after the address byte
+  advanceMicros(ECCX08Simulator::transferTime(result == 0 ? length : 0, _frequency));
+
+  return result;
+}
+
+size_t ECCX08SimulatorTransport::read(uint8_t address, byte data[], size_t length)
+{
+  size_t received = _simulator->busRead(address, data, length);
+
+  advanceMicros(ECCX08Simulator::transferTime(received, _frequency));
+
+  return received;
+}
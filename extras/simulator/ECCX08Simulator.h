@@ -0,0 +1,157 @@
+/*
+  This file is part of the ArduinoECCX08 library.
+  Copyright (c) 2026 Operator Foundation. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+// Software model of an ATECC508A/608A as seen from the I2C bus.
+//
+// It implements the wake/idle/sleep word addresses, the command packet
+// framing and CRC, NACKing while asleep or busy, the watchdog, and the
+// opcodes this library issues.  Execution times are virtual and can be set
+// per opcode, so driver latency can be measured deterministically.
+//
+// The elliptic curve commands are NOT P-256: GenKey, Sign, Verify and ECDH
+// run over a small multiplicative group so that keys, signatures and shared
+// secrets are self-consistent, but they will not interoperate with real
+// ECDSA/ECDH implementations.
+
+#ifndef _ECCX08_SIMULATOR_H_
+#define _ECCX08_SIMULATOR_H_
+
+#include "Arduino.h"
+#include "SimulatorCrypto.h"
+
+#include "ECCX08Transport.h"
+
+class ECCX08Simulator
+{
+public:
+  enum Revision {
+    ATECC508A,
+    ATECC608A
+  };
+
+  struct Stats {
+    unsigned long wakes;
+    unsigned long idles;
+    unsigned long sleeps;
+    unsigned long watchdogSleeps;
+    unsigned long commands;
+    unsigned long nacks;
+    unsigned long bytesWritten;
+    unsigned long bytesRead;
+  };
+
+  ECCX08Simulator(Revision revision = ATECC608A, uint8_t address = 0x60);
+
+  Revision revision() const;
+
+  // execution time model, in microseconds of virtual time
+  void setExecutionTime(uint8_t opcode, unsigned long us);
+  unsigned long executionTime(uint8_t opcode) const;
+  void setWatchdogTimeout(unsigned long us);
+
+  void setRandomSeed(uint64_t seed);
+  void setSlot(int slot, const byte data[], size_t length);
+  void setLocked(bool configLocked, bool dataLocked);
+
+  const Stats& stats() const;
+  void resetStats();
+
+  // bus side, called by TwoWire and ECCX08SimulatorTransport
+  int busWrite(uint8_t address, const uint8_t data[], size_t length, uint32_t frequency);
+  size_t busRead(uint8_t address, uint8_t data[], size_t length);
+
+  // how long a transfer of this many data bytes keeps the bus busy
+  static unsigned long transferTime(size_t length, uint32_t frequency);
+
+private:
+  enum State {
+    STATE_SLEEP,
+    STATE_IDLE,
+    STATE_ACTIVE
+  };
+
+  void checkWatchdog();
+  void clearVolatile();
+
+  void execute(const uint8_t packet[], size_t length);
+  void respond(const uint8_t data[], size_t length);
+  void respondStatus(uint8_t status);
+
+  void read(uint8_t zone, uint16_t address);
+  void write(uint8_t zone, uint16_t address, const uint8_t data[], size_t length);
+  void lock(uint8_t mode);
+  void random();
+  void nonce(uint8_t mode, const uint8_t data[], size_t length);
+  void info(uint8_t mode);
+  void genKey(uint8_t mode, uint16_t slot);
+  void sign(uint8_t mode, uint16_t slot);
+  void verify(uint8_t mode, const uint8_t data[], size_t length);
+  void ecdh(uint8_t mode, uint16_t slot, const uint8_t data[], size_t length);
+  void sha(uint8_t mode, uint16_t length, const uint8_t data[], size_t dataLength);
+  void aes(uint8_t mode, uint16_t slot, const uint8_t data[], size_t length);
+
+  uint8_t* zoneAddress(uint8_t zone, uint16_t address, size_t length);
+  uint64_t nextRandom();
+
+  Revision _revision;
+  uint8_t _address;
+
+  unsigned long _executionTimes[256];
+  unsigned long _watchdogTimeout;
+
+  State _state;
+  unsigned long _wakeTime;
+  unsigned long _readyTime;
+  uint64_t _randomState;
+
+  uint8_t _config[128];
+  uint8_t _otp[64];
+  uint8_t _slots[16][416];
+
+  uint8_t _tempKey[32];
+  bool _tempKeyValid;
+
+  SimSha256 _sha;
+  bool _shaActive;
+
+  uint8_t _output[75];
+  size_t _outputLength;
+  size_t _outputOffset;
+
+  Stats _stats;
+};
+
+// connects an ECCX08Class straight to the simulator, without going
+// through the TwoWire stand-in
+class ECCX08SimulatorTransport : public ECCX08Transport
+{
+public:
+  ECCX08SimulatorTransport(ECCX08Simulator& simulator);
+
+  virtual void setClock(uint32_t frequency);
+
+  virtual int write(uint8_t address, const byte data[], size_t length);
+  virtual size_t read(uint8_t address, byte data[], size_t length);
+
+private:
+  ECCX08Simulator* _simulator;
+  uint32_t _frequency;
+};
+
+#endif
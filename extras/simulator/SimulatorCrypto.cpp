@@ -0,0 +1,356 @@
+/*
+  This file is part of the ArduinoECCX08 library.
+  Copyright (c) 2026 Operator Foundation. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "SimulatorCrypto.h"
+
+#include <string.h>
+
+uint16_t simCrc16(const uint8_t data[], size_t length)
+{
+  uint16_t crc = 0;
+
+  // bit serial, as in the datasheet
+  for (size_t i = 0; i < length; i++) {
+    for (uint8_t shift = 0x01; shift > 0x00; shift <<= 1) {
+      uint8_t dataBit = (data[i] & shift) ? 1 : 0;
+      uint8_t crcBit = crc >> 15;
+
+      crc <<= 1;
+
+      if (dataBit != crcBit) {
+        crc ^= 0x8005;
+      }
+    }
+  }
+
+  return crc;
+}
+
+static const uint32_t sha256K[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static uint32_t rotr(uint32_t x, int n)
+{
+  return (x >> n) | (x << (32 - n));
+}
+
+static void sha256Block(SimSha256& ctx)
+{
+  uint32_t w[64];
+
+  for (int i = 0; i < 16; i++) {
+    w[i] = ((uint32_t)ctx.block[i * 4] << 24) | ((uint32_t)ctx.block[i * 4 + 1] << 16) |
+           ((uint32_t)ctx.block[i * 4 + 2] << 8) | ctx.block[i * 4 + 3];
+  }
+
+  for (int i = 16; i < 64; i++) {
+    uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+    uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+
+  uint32_t v[8];
+  memcpy(v, ctx.state, sizeof(v));
+
+  for (int i = 0; i < 64; i++) {
+    uint32_t s1 = rotr(v[4], 6) ^ rotr(v[4], 11) ^ rotr(v[4], 25);
+    uint32_t ch = (v[4] & v[5]) ^ (~v[4] & v[6]);
+    uint32_t t1 = v[7] + s1 + ch + sha256K[i] + w[i];
+    uint32_t s0 = rotr(v[0], 2) ^ rotr(v[0], 13) ^ rotr(v[0], 22);
+    uint32_t maj = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+
+    memmove(&v[1], &v[0], 7 * sizeof(v[0]));
+    v[4] += t1;
+    v[0] = t1 + s0 + maj;
+  }
+
+  for (int i = 0; i < 8; i++) {
+    ctx.state[i] += v[i];
+  }
+}
+
+void simSha256Init(SimSha256& ctx)
+{
+  static const uint32_t initial[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+  };
+
+  memcpy(ctx.state, initial, sizeof(initial));
+  ctx.blockLength = 0;
+  ctx.totalLength = 0;
+}
+
+void simSha256Update(SimSha256& ctx, const uint8_t data[], size_t length)
+{
+  ctx.totalLength += length;
+
+  while (length > 0) {
+    size_t chunk = 64 - ctx.blockLength;
+
+    if (chunk > length) {
+      chunk = length;
+    }
+
+    memcpy(&ctx.block[ctx.blockLength], data, chunk);
+    ctx.blockLength += chunk;
+    data += chunk;
+    length -= chunk;
+
+    if (ctx.blockLength == 64) {
+      sha256Block(ctx);
+      ctx.blockLength = 0;
+    }
+  }
+}
+
+void simSha256Final(SimSha256& ctx, uint8_t digest[32])
+{
+  uint64_t bits = ctx.totalLength * 8;
+
+  ctx.block[ctx.blockLength++] = 0x80;
+
+  if (ctx.blockLength > 56) {
+    memset(&ctx.block[ctx.blockLength], 0, 64 - ctx.blockLength);
+    sha256Block(ctx);
+    ctx.blockLength = 0;
+  }
+
+  memset(&ctx.block[ctx.blockLength], 0, 56 - ctx.blockLength);
+
+  for (int i = 0; i < 8; i++) {
+    ctx.block[63 - i] = bits >> (i * 8);
+  }
+
+  sha256Block(ctx);
+
+  for (int i = 0; i < 32; i++) {
+    digest[i] = ctx.state[i / 4] >> (24 - (i % 4) * 8);
+  }
+}
+
+void simSha256(const uint8_t data[], size_t length, uint8_t digest[32])
+{
+  SimSha256 ctx;
+
+  simSha256Init(ctx);
+  simSha256Update(ctx, data, length);
+  simSha256Final(ctx, digest);
+}
+
+// AES-128 straight from FIPS-197, with the S-box derived at first use
+
+static uint8_t sbox[256];
+static uint8_t inverseSbox[256];
+
+static uint8_t xtime(uint8_t x)
+{
+  return (x << 1) ^ ((x & 0x80) ? 0x1b : 0x00);
+}
+
+static uint8_t gmul(uint8_t a, uint8_t b)
+{
+  uint8_t result = 0;
+
+  while (b) {
+    if (b & 1) {
+      result ^= a;
+    }
+
+    a = xtime(a);
+    b >>= 1;
+  }
+
+  return result;
+}
+
+static void initSbox()
+{
+  if (sbox[0] == 0x63) {
+    return;
+  }
+
+  for (int i = 0; i < 256; i++) {
+    uint8_t inverse = 0;
+
+    for (int j = 1; i != 0 && j < 256; j++) {
+      if (gmul(i, j) == 1) {
+        inverse = j;
+        break;
+      }
+    }
+
+    uint8_t s = inverse;
+
+    for (int k = 1; k < 5; k++) {
+      s ^= (inverse << k) | (inverse >> (8 - k));
+    }
+
+    s ^= 0x63;
+
+    sbox[i] = s;
+    inverseSbox[s] = i;
+  }
+}
+
+static void expandKey(const uint8_t key[16], uint8_t schedule[176])
+{
+  uint8_t rcon = 0x01;
+
+  memcpy(schedule, key, 16);
+
+  for (int i = 16; i < 176; i += 4) {
+    uint8_t t[4];
+
+    memcpy(t, &schedule[i - 4], 4);
+
+    if ((i % 16) == 0) {
+      uint8_t first = t[0];
+
+      t[0] = sbox[t[1]] ^ rcon;
+      t[1] = sbox[t[2]];
+      t[2] = sbox[t[3]];
+      t[3] = sbox[first];
+      rcon = xtime(rcon);
+    }
+
+    for (int j = 0; j < 4; j++) {
+      schedule[i + j] = schedule[i - 16 + j] ^ t[j];
+    }
+  }
+}
+
+void simAes128Encrypt(const uint8_t key[16], const uint8_t input[16], uint8_t output[16])
+{
+  uint8_t schedule[176];
+  uint8_t s[16];
+
+  initSbox();
+  expandKey(key, schedule);
+
+  for (int i = 0; i < 16; i++) {
+    s[i] = input[i] ^ schedule[i];
+  }
+
+  for (int round = 1; round <= 10; round++) {
+    uint8_t t[16];
+
+    // SubBytes and ShiftRows, the state is column major
+    for (int i = 0; i < 16; i++) {
+      t[i] = sbox[s[(i + (i % 4) * 4) % 16]];
+    }
+
+    // MixColumns
+    for (int c = 0; round < 10 && c < 4; c++) {
+      uint8_t* col = &t[c * 4];
+      uint8_t a0 = col[0], a1 = col[1], a2 = col[2], a3 = col[3];
+
+      col[0] = xtime(a0) ^ xtime(a1) ^ a1 ^ a2 ^ a3;
+      col[1] = a0 ^ xtime(a1) ^ xtime(a2) ^ a2 ^ a3;
+      col[2] = a0 ^ a1 ^ xtime(a2) ^ xtime(a3) ^ a3;
+      col[3] = xtime(a0) ^ a0 ^ a1 ^ a2 ^ xtime(a3);
+    }
+
+    for (int i = 0; i < 16; i++) {
+      s[i] = t[i] ^ schedule[round * 16 + i];
+    }
+  }
+
+  memcpy(output, s, 16);
+}
+
+void simAes128Decrypt(const uint8_t key[16], const uint8_t input[16], uint8_t output[16])
+{
+  uint8_t schedule[176];
+  uint8_t s[16];
+
+  initSbox();
+  expandKey(key, schedule);
+
+  for (int i = 0; i < 16; i++) {
+    s[i] = input[i] ^ schedule[160 + i];
+  }
+
+  for (int round = 9; round >= 0; round--) {
+    uint8_t t[16];
+
+    // InvShiftRows and InvSubBytes
+    for (int i = 0; i < 16; i++) {
+      t[(i + (i % 4) * 4) % 16] = inverseSbox[s[i]];
+    }
+
+    for (int i = 0; i < 16; i++) {
+      t[i] ^= schedule[round * 16 + i];
+    }
+
+    // InvMixColumns
+    for (int c = 0; round > 0 && c < 4; c++) {
+      uint8_t* col = &t[c * 4];
+      uint8_t a0 = col[0], a1 = col[1], a2 = col[2], a3 = col[3];
+
+      col[0] = gmul(a0, 14) ^ gmul(a1, 11) ^ gmul(a2, 13) ^ gmul(a3, 9);
+      col[1] = gmul(a0, 9) ^ gmul(a1, 14) ^ gmul(a2, 11) ^ gmul(a3, 13);
+      col[2] = gmul(a0, 13) ^ gmul(a1, 9) ^ gmul(a2, 14) ^ gmul(a3, 11);
+      col[3] = gmul(a0, 11) ^ gmul(a1, 13) ^ gmul(a2, 9) ^ gmul(a3, 14);
+    }
+
+    memcpy(s, t, 16);
+  }
+
+  memcpy(output, s, 16);
+}
+
+void simGf128Multiply(const uint8_t x[16], const uint8_t y[16], uint8_t result[16])
+{
+  uint8_t z[16];
+  uint8_t v[16];
+
+  memset(z, 0, sizeof(z));
+  memcpy(v, y, sizeof(v));
+
+  for (int i = 0; i < 128; i++) {
+    if (x[i / 8] & (0x80 >> (i % 8))) {
+      for (int j = 0; j < 16; j++) {
+        z[j] ^= v[j];
+      }
+    }
+
+    bool lsb = v[15] & 0x01;
+
+    for (int j = 15; j > 0; j--) {
+      v[j] = (v[j] >> 1) | (v[j - 1] << 7);
+    }
+
+    v[0] >>= 1;
+
+    if (lsb) {
+      v[0] ^= 0xe1;
+    }
+  }
+
+  memcpy(result, z, 16);
+}
@@ -0,0 +1,51 @@
+/*
+  This file is part of the ArduinoECCX08 library.
+  Copyright (c) 2026 Operator Foundation. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+// Small, slow reference primitives for the simulator.  They are written
+// independently of the library's own crypto code so that the two can be
+// checked against each other.
+
+#ifndef _SIMULATOR_CRYPTO_H_
+#define _SIMULATOR_CRYPTO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+// the packet CRC from the datasheet, one bit at a time
+uint16_t simCrc16(const uint8_t data[], size_t length);
+
+struct SimSha256 {
+  uint32_t state[8];
+  uint8_t block[64];
+  size_t blockLength;
+  uint64_t totalLength;
+};
+
+void simSha256Init(SimSha256& ctx);
+void simSha256Update(SimSha256& ctx, const uint8_t data[], size_t length);
+void simSha256Final(SimSha256& ctx, uint8_t digest[32]);
+void simSha256(const uint8_t data[], size_t length, uint8_t digest[32]);
+
+void simAes128Encrypt(const uint8_t key[16], const uint8_t input[16], uint8_t output[16]);
+void simAes128Decrypt(const uint8_t key[16], const uint8_t input[16], uint8_t output[16]);
+
+// GCM field multiply as in NIST SP 800-38D, algorithm 1
+void simGf128Multiply(const uint8_t x[16], const uint8_t y[16], uint8_t result[16]);
+
+#endif
@@ -0,0 +1,124 @@
+/*
+  This file is part of the ArduinoECCX08 library.
+  Copyright (c) 2026 Operator Foundation. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "Wire.h"
+#include "ECCX08Simulator.h"
+
+TwoWire::TwoWire() :
+  _device(NULL),
+  _frequency(100000),
+  _txAddress(0),
+  _txLength(0),
+  _rxLength(0),
+  _rxIndex(0)
+{
+}
+
+void TwoWire::attach(ECCX08Simulator* device)
+{
+  _device = device;
+}
+
+void TwoWire::begin()
+{
+}
+
+void TwoWire::end()
+{
+}
+
+void TwoWire::setClock(uint32_t frequency)
+{
+  _frequency = frequency;
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+  _txAddress = address;
+  _txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t data)
+{
+  return write(&data, 1);
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t length)
+{
+  if (length > sizeof(_txBuffer) - _txLength) {
+    length = sizeof(_txBuffer) - _txLength;
+  }
+
+  memcpy(&_txBuffer[_txLength], data, length);
+  _txLength += length;
+
+  return length;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop)
+{
+  (void)sendStop;
+
+  int result = 2; // NACK on address, nobody there
+
+  if (_device != NULL) {
+    result = _device->busWrite(_txAddress, _txBuffer, _txLength, _frequency);
+  }
+
+  // a NACK ends the transfer after the address byte
+  advanceMicros(ECCX08Simulator::transferTime(result == 0 ? _txLength : 0, _frequency));
+
+  return result;
+}
+
+size_t TwoWire::requestFrom(uint8_t address, size_t quantity, bool sendStop)
+{
+  (void)sendStop;
+
+  if (quantity > sizeof(_rxBuffer)) {
+    quantity = sizeof(_rxBuffer);
+  }
+
+  _rxLength = 0;
+  _rxIndex = 0;
+
+  if (_device != NULL) {
+    _rxLength = _device->busRead(address, _rxBuffer, quantity);
+  }
+
+  advanceMicros(ECCX08Simulator::transferTime(_rxLength, _frequency));
+
+  return _rxLength;
+}
+
+int TwoWire::available()
+{
+  return _rxLength - _rxIndex;
+}
+
+int TwoWire::read()
+{
+  if (_rxIndex >= _rxLength) {
+    return -1;
+  }
+
+  return _rxBuffer[_rxIndex++];
+}
+
+TwoWire Wire;
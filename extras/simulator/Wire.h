@@ -0,0 +1,67 @@
+/*
+  This file is part of the ArduinoECCX08 library.
+  Copyright (c) 2026 Operator Foundation. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+// TwoWire stand-in that routes transfers to an attached ECCX08Simulator and
+// charges the virtual clock for the time they would take on the bus.
+
+#ifndef _SIMULATOR_WIRE_H_
+#define _SIMULATOR_WIRE_H_
+
+#include "Arduino.h"
+
+#define WIRE_HAS_END 1
+
+class ECCX08Simulator;
+
+class TwoWire
+{
+public:
+  TwoWire();
+
+  void attach(ECCX08Simulator* device);
+
+  void begin();
+  void end();
+  void setClock(uint32_t frequency);
+
+  void beginTransmission(uint8_t address);
+  size_t write(uint8_t data);
+  size_t write(const uint8_t* data, size_t length);
+  uint8_t endTransmission(bool sendStop = true);
+
+  size_t requestFrom(uint8_t address, size_t quantity, bool sendStop = true);
+  int available();
+  int read();
+
+private:
+  ECCX08Simulator* _device;
+  uint32_t _frequency;
+
+  uint8_t _txAddress;
+  uint8_t _txBuffer[256];
+  size_t _txLength;
+
+  uint8_t _rxBuffer[256];
+  size_t _rxLength;
+  size_t _rxIndex;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,1603 @@
+/*
+  This file is part of the ArduinoECCX08 library.
+  Copyright (c) 2026 Operator Foundation. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+// Runs the driver against the simulator, checks the results and prints the
+// virtual time each operation took.  Exits non-zero if any check fails.
+
+#include <stdio.h>
+
+#include <chrono>
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "ECCX08.h"
+#include "AES.h"
+#include "CTRDRBG.h"
+#include "CTR.h"
+#include "EAX.h"
+#include "OMAC.h"
+#include "XTS.h"
+#include "GCM.h"
+#include "GF128.h"
+#include "GHASH.h"
+#include "ECCX08Simulator.h"
+
+static int failures = 0;
+
+static ECCX08Simulator* device;
+static unsigned long startTime;
+static ECCX08Simulator::Stats startStats;
+
+static void begin()
+{
+  startTime = micros();
+  startStats = device->stats();
+}
+
+static void end(const char* name, bool ok)
+{
+  const ECCX08Simulator::Stats& stats = device->stats();
+
+  printf("  %-28s %9lu us %4lu wakes %5lu cmds %6lu nacks  %s\n", name,
+         micros() - startTime,
+         stats.wakes - startStats.wakes,
+         stats.commands - startStats.commands,
+         stats.nacks - startStats.nacks,
+         ok ? "ok" : "FAILED");
+
+  if (!ok) {
+    failures++;
+  }
+}
+
+// FIPS-197 appendix C, the plaintext and key bytes count up from zero
+static const byte aesPlaintext[16] = {
+  0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+};
+static const byte aesCiphertext[3][16] = {
+  { 0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a },
+  { 0xdd, 0xa9, 0x7c, 0xa4, 0x86, 0x4c, 0xdf, 0xe0, 0x6e, 0xaf, 0x70, 0xa0, 0xec, 0x0d, 0x71, 0x91 },
+  { 0x8e, 0xa2, 0xb7, 0xca, 0x51, 0x67, 0x45, 0xbf, 0xea, 0xfc, 0x49, 0x90, 0x4b, 0x49, 0x60, 0x89 }
+};
+
+static bool checkCipher(BlockCipher& cipher, const byte expected[16])
+{
+  byte key[32];
+  byte block[16];
+
+  for (size_t i = 0; i < sizeof(key); i++) {
+    key[i] = i;
+  }
+
+  if (!cipher.setKey(key, cipher.keySize())) {
+    return false;
+  }
+
+  cipher.encryptBlock(block, aesPlaintext);
+
+  if (memcmp(block, expected, 16) != 0) {
+    return false;
+  }
+
+  cipher.decryptBlock(block, block);
+
+  return memcmp(block, aesPlaintext, 16) == 0;
+}
+
+// NIST GCM test case 2: GHASH of one ciphertext block and the lengths
+static const byte ghashKey[16] = {
+  0x66, 0xe9, 0x4b, 0xd4, 0xef, 0x8a, 0x2c, 0x3b, 0x88, 0x4c, 0xfa, 0x59, 0xca, 0x34, 0x2b, 0x2e
+};
+static const byte ghashInput[32] = {
+  0x03, 0x88, 0xda, 0xce, 0x60, 0xb6, 0xa3, 0x92, 0xf3, 0x28, 0xc2, 0xb9, 0x71, 0xb2, 0xfe, 0x78,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80
+};
+static const byte ghashExpected[16] = {
+  0xf3, 0x8c, 0xbb, 0x1a, 0xd6, 0x92, 0x23, 0xdc, 0xc3, 0x45, 0x7a, 0xe5, 0xb6, 0xb0, 0xf8, 0x85
+};
+
+static bool checkGhash(bool chip)
+{
+  GHASH ghash;
+  byte token[16];
+
+  ghash.useChip(chip);
+  ghash.reset(ghashKey);
+  ghash.update(ghashInput, sizeof(ghashInput));
+
+  return ghash.finalize(token, sizeof(token)) && memcmp(token, ghashExpected, 16) == 0;
+}
+
+// long updates take the multi-block paths, so compare them against the
+// reference one block at a time, with a partial block at the end
+static bool checkGhashBlocks()
+{
+  GHASH ghash;
+  byte data[7 * 16 + 5];
+  byte expected[16];
+  byte token[16];
+
+  for (size_t i = 0; i < sizeof(data); i++) {
+    data[i] = i * 11 + 3;
+  }
+
+  memset(expected, 0, sizeof(expected));
+
+  for (size_t posn = 0; posn < sizeof(data); posn += 16) {
+    for (size_t i = 0; i < 16 && posn + i < sizeof(data); i++) {
+      expected[i] ^= data[posn + i];
+    }
+
+    simGf128Multiply(expected, ghashKey, expected);
+  }
+
+  ghash.reset(ghashKey);
+  ghash.update(data, sizeof(data));
+  ghash.finalize(token, sizeof(token));
+
+  return memcmp(token, expected, 16) == 0;
+}
+
+// every multiply variant against the bit by bit reference
+static bool checkGf128()
+{
+  static uint32_t M8[256][4];
+  uint32_t H[4];
+  uint32_t M4[16][4];
+  byte x[16];
+  byte y[16];
+  byte expected[16];
+
+  for (int n = 0; n < 32; n++) {
+    for (int i = 0; i < 16; i++) {
+      x[i] = n * 31 + i * 17 + 1;
+      y[i] = (n == 0) ? 0xff : n * 13 + i * 29 + 7;
+    }
+
+    simGf128Multiply(x, y, expected);
+
+    GF128::mulInit(H, y);
+    GF128::mulInitTable4(M4, y);
+    GF128::mulInitTable8(M8, y);
+
+    uint32_t Y[4];
+
+    memcpy(Y, x, 16);
+    GF128::mul(Y, H);
+    if (memcmp(Y, expected, 16) != 0) {
+      return false;
+    }
+
+    memcpy(Y, x, 16);
+    GF128::mulTable4(Y, M4);
+    if (memcmp(Y, expected, 16) != 0) {
+      return false;
+    }
+
+    memcpy(Y, x, 16);
+    GF128::mulTable8(Y, M8);
+    if (memcmp(Y, expected, 16) != 0) {
+      return false;
+    }
+  }
+
+  return checkGhash(false) && checkGhashBlocks();
+}
+
+// NIST GCM test case 4, and test case 5 which has a 64-bit IV
+static const byte gcmKey[16] = {
+  0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c, 0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08
+};
+static const byte gcmPlaintext[60] = {
+  0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5, 0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a,
+  0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda, 0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72,
+  0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53, 0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25,
+  0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57, 0xba, 0x63, 0x7b, 0x39
+};
+static const byte gcmAuthData[20] = {
+  0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef, 0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+  0xab, 0xad, 0xda, 0xd2
+};
+static const byte gcmIV[12] = {
+  0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad, 0xde, 0xca, 0xf8, 0x88
+};
+static const byte gcmCiphertext[2][60] = {
+  { 0x42, 0x83, 0x1e, 0xc2, 0x21, 0x77, 0x74, 0x24, 0x4b, 0x72, 0x21, 0xb7, 0x84, 0xd0, 0xd4, 0x9c,
+    0xe3, 0xaa, 0x21, 0x2f, 0x2c, 0x02, 0xa4, 0xe0, 0x35, 0xc1, 0x7e, 0x23, 0x29, 0xac, 0xa1, 0x2e,
+    0x21, 0xd5, 0x14, 0xb2, 0x54, 0x66, 0x93, 0x1c, 0x7d, 0x8f, 0x6a, 0x5a, 0xac, 0x84, 0xaa, 0x05,
+    0x1b, 0xa3, 0x0b, 0x39, 0x6a, 0x0a, 0xac, 0x97, 0x3d, 0x58, 0xe0, 0x91 },
+  { 0x61, 0x35, 0x3b, 0x4c, 0x28, 0x06, 0x93, 0x4a, 0x77, 0x7f, 0xf5, 0x1f, 0xa2, 0x2a, 0x47, 0x55,
+    0x69, 0x9b, 0x2a, 0x71, 0x4f, 0xcd, 0xc6, 0xf8, 0x37, 0x66, 0xe5, 0xf9, 0x7b, 0x6c, 0x74, 0x23,
+    0x73, 0x80, 0x69, 0x00, 0xe4, 0x9f, 0x24, 0xb2, 0x2b, 0x09, 0x75, 0x44, 0xd4, 0x89, 0x6b, 0x42,
+    0x49, 0x89, 0xb5, 0xe1, 0xeb, 0xac, 0x0f, 0x07, 0xc2, 0x3f, 0x45, 0x98 }
+};
+static const byte gcmTag[2][16] = {
+  { 0x5b, 0xc9, 0x4f, 0xbc, 0x32, 0x21, 0xa5, 0xdb, 0x94, 0xfa, 0xe9, 0x5a, 0xe7, 0x12, 0x1a, 0x47 },
+  { 0x36, 0x12, 0xd2, 0xe7, 0x9e, 0x3b, 0x07, 0x85, 0x56, 0x1b, 0xe1, 0x4a, 0xac, 0xa2, 0xfc, 0xcb }
+};
+
+// encrypt and decrypt each vector twice, so the second time round runs on
+// the cached hash key
+static bool checkGcm(GCMCommon& gcm)
+{
+  byte buffer[60];
+  byte tag[16];
+
+  if (!gcm.setKey(gcmKey, sizeof(gcmKey))) {
+    return false;
+  }
+
+  for (int n = 0; n < 4; n++) {
+    int test = n % 2;
+
+    gcm.setIV(gcmIV, test ? 8 : 12);
+    gcm.addAuthData(gcmAuthData, sizeof(gcmAuthData));
+    gcm.encrypt(buffer, gcmPlaintext, sizeof(gcmPlaintext));
+    gcm.computeTag(tag, sizeof(tag));
+
+    if (memcmp(buffer, gcmCiphertext[test], 60) != 0 || memcmp(tag, gcmTag[test], 16) != 0) {
+      return false;
+    }
+
+    gcm.setIV(gcmIV, test ? 8 : 12);
+    gcm.addAuthData(gcmAuthData, sizeof(gcmAuthData));
+    gcm.decrypt(buffer, buffer, sizeof(buffer));
+
+    if (!gcm.checkTag(gcmTag[test], 16) || memcmp(buffer, gcmPlaintext, 60) != 0) {
+      return false;
+    }
+
+    // split so that the runs start and end part way through a block
+    gcm.setIV(gcmIV, test ? 8 : 12);
+    gcm.addAuthData(gcmAuthData, sizeof(gcmAuthData));
+    gcm.encrypt(buffer, gcmPlaintext, 7);
+    gcm.encrypt(buffer + 7, gcmPlaintext + 7, 41);
+    gcm.encrypt(buffer + 48, gcmPlaintext + 48, 12);
+    gcm.computeTag(tag, sizeof(tag));
+
+    if (memcmp(buffer, gcmCiphertext[test], 60) != 0 || memcmp(tag, gcmTag[test], 16) != 0) {
+      return false;
+    }
+
+    gcm.setIV(gcmIV, test ? 8 : 12);
+    gcm.addAuthData(gcmAuthData, sizeof(gcmAuthData));
+    gcm.decrypt(buffer, buffer, 25);
+    gcm.decrypt(buffer + 25, buffer + 25, 35);
+
+    if (!gcm.checkTag(gcmTag[test], 16) || memcmp(buffer, gcmPlaintext, 60) != 0) {
+      return false;
+    }
+
+    // the same again through seal() and open(), in place
+    memcpy(buffer, gcmPlaintext, sizeof(buffer));
+
+    if (!gcm.seal(-1, gcmIV, test ? 8 : 12, gcmAuthData, sizeof(gcmAuthData),
+                  buffer, buffer, sizeof(buffer), tag, sizeof(tag)) ||
+        memcmp(buffer, gcmCiphertext[test], 60) != 0 || memcmp(tag, gcmTag[test], 16) != 0) {
+      return false;
+    }
+
+    if (!gcm.open(-1, gcmIV, test ? 8 : 12, gcmAuthData, sizeof(gcmAuthData),
+                  buffer, buffer, sizeof(buffer), tag, sizeof(tag)) ||
+        memcmp(buffer, gcmPlaintext, 60) != 0) {
+      return false;
+    }
+
+    // a bad tag must fail and leave no plaintext behind
+    tag[0] ^= 0x01;
+
+    if (gcm.open(-1, gcmIV, test ? 8 : 12, gcmAuthData, sizeof(gcmAuthData),
+                 buffer, gcmCiphertext[test], sizeof(buffer), tag, sizeof(tag)) ||
+        buffer[0] != 0 || buffer[59] != 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// NIST SP 800-38A F.5.1, CTR-AES128.Encrypt
+static const byte ctrKey[16] = {
+  0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+};
+static const byte ctrIV[16] = {
+  0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff
+};
+static const byte ctrPlaintext[64] = {
+  0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+  0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+  0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+  0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10
+};
+static const byte ctrCiphertext[64] = {
+  0x87, 0x4d, 0x61, 0x91, 0xb6, 0x20, 0xe3, 0x26, 0x1b, 0xef, 0x68, 0x64, 0x99, 0x0d, 0xb6, 0xce,
+  0x98, 0x06, 0xf6, 0x6b, 0x79, 0x70, 0xfd, 0xff, 0x86, 0x17, 0x18, 0x7b, 0xb9, 0xff, 0xfd, 0xff,
+  0x5a, 0xe4, 0xdf, 0x3e, 0xdb, 0xd5, 0xd3, 0x5e, 0x5b, 0x4f, 0x09, 0x02, 0x0d, 0xb0, 0x3e, 0xab,
+  0x1e, 0x03, 0x1d, 0xda, 0x2f, 0xbe, 0x03, 0xd1, 0x79, 0x21, 0x70, 0xa0, 0xf3, 0x00, 0x9c, 0xee
+};
+
+// the known answer in odd sized pieces, with keystream computed ahead of
+// time part way through, then a one byte counter wrapping around
+static bool checkCtr()
+{
+  CTR<AES128> ctr;
+  AES128 aes;
+  byte buffer[64];
+  byte iv[16];
+  byte expected[16];
+
+  ctr.setKey(ctrKey, sizeof(ctrKey));
+  ctr.setIV(ctrIV, sizeof(ctrIV));
+  ctr.encrypt(buffer, ctrPlaintext, 5);
+  ctr.encrypt(buffer + 5, ctrPlaintext + 5, 22);
+
+  // 5 bytes of the second block are left, so only three more blocks fit
+  if (ctr.precompute() != 53 || ctr.available() != 53) {
+    return false;
+  }
+
+  ctr.encrypt(buffer + 27, ctrPlaintext + 27, 37);
+
+  if (memcmp(buffer, ctrCiphertext, sizeof(buffer)) != 0) {
+    return false;
+  }
+
+  ctr.setIV(ctrIV, sizeof(ctrIV));
+  ctr.decrypt(buffer, buffer, sizeof(buffer));
+
+  if (memcmp(buffer, ctrPlaintext, sizeof(buffer)) != 0) {
+    return false;
+  }
+
+  memcpy(iv, ctrIV, sizeof(iv));
+  ctr.setCounterSize(1);
+  ctr.setIV(iv, sizeof(iv));
+  memset(buffer, 0, 32);
+  ctr.encrypt(buffer, buffer, 32);
+
+  iv[15] = 0x00;
+  aes.setKey(ctrKey, sizeof(ctrKey));
+  aes.encryptBlock(expected, iv);
+
+  return memcmp(&buffer[16], expected, 16) == 0;
+}
+
+// IEEE 1619-2007 XTS-AES-128 vectors 2 and 15, the second of which uses
+// ciphertext stealing on a 17 byte sector
+static const byte xtsKey[2][32] = {
+  { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22 },
+  { 0xff, 0xfe, 0xfd, 0xfc, 0xfb, 0xfa, 0xf9, 0xf8, 0xf7, 0xf6, 0xf5, 0xf4, 0xf3, 0xf2, 0xf1, 0xf0,
+    0xbf, 0xbe, 0xbd, 0xbc, 0xbb, 0xba, 0xb9, 0xb8, 0xb7, 0xb6, 0xb5, 0xb4, 0xb3, 0xb2, 0xb1, 0xb0 }
+};
+static const byte xtsTweak[2][5] = {
+  { 0x33, 0x33, 0x33, 0x33, 0x33 },
+  { 0x9a, 0x78, 0x56, 0x34, 0x12 }
+};
+static const byte xtsCiphertext[2][32] = {
+  { 0xc4, 0x54, 0x18, 0x5e, 0x6a, 0x16, 0x93, 0x6e, 0x39, 0x33, 0x40, 0x38, 0xac, 0xef, 0x83, 0x8b,
+    0xfb, 0x18, 0x6f, 0xff, 0x74, 0x80, 0xad, 0xc4, 0x28, 0x93, 0x82, 0xec, 0xd6, 0xd3, 0x94, 0xf0 },
+  { 0x6c, 0x16, 0x25, 0xdb, 0x46, 0x71, 0x52, 0x2d, 0x3d, 0x75, 0x99, 0x60, 0x1d, 0xe7, 0xca, 0x09,
+    0xed }
+};
+
+static bool checkXts()
+{
+  XTS<AES128> xts;
+  byte plaintext[32];
+  byte buffer[512];
+  byte expected[512];
+
+  for (int test = 0; test < 2; test++) {
+    size_t size = test ? 17 : 32;
+
+    for (size_t i = 0; i < size; i++) {
+      plaintext[i] = test ? i : 0x44;
+    }
+
+    xts.setKey(xtsKey[test], sizeof(xtsKey[test]));
+    xts.setSectorSize(size);
+    xts.setTweak(xtsTweak[test], sizeof(xtsTweak[test]));
+    xts.encryptSector(buffer, plaintext);
+
+    if (memcmp(buffer, xtsCiphertext[test], size) != 0) {
+      return false;
+    }
+
+    xts.decryptSector(buffer, buffer);
+
+    if (memcmp(buffer, plaintext, size) != 0) {
+      return false;
+    }
+  }
+
+  // in place round trips over every tail length, and the same sectors
+  // through the bitsliced AES, whose multi-block path is different
+  XTS<AESBitsliced128> other;
+
+  other.setKey(xtsKey[1], sizeof(xtsKey[1]));
+
+  for (size_t size = 16; size <= sizeof(buffer); size += 7) {
+    for (size_t i = 0; i < size; i++) {
+      buffer[i] = i * 13;
+    }
+
+    xts.setSectorSize(size);
+    xts.setTweak(xtsTweak[1], sizeof(xtsTweak[1]));
+    xts.encryptSector(buffer, buffer);
+
+    other.setSectorSize(size);
+    other.setTweak(xtsTweak[1], sizeof(xtsTweak[1]));
+    other.decryptSector(expected, buffer);
+
+    xts.setTweak(xtsTweak[1], sizeof(xtsTweak[1]));
+    xts.decryptSector(buffer, buffer);
+
+    for (size_t i = 0; i < size; i++) {
+      if (buffer[i] != (byte)(i * 13) || expected[i] != buffer[i]) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+// RFC 4493 AES-CMAC examples 1 and 2, with the NIST SP 800-38A key and
+// plaintext that the CTR check already uses
+static const byte cmacTag[2][16] = {
+  { 0xbb, 0x1d, 0x69, 0x29, 0xe9, 0x59, 0x37, 0x28, 0x7f, 0xa3, 0x7d, 0x12, 0x9b, 0x75, 0x67, 0x46 },
+  { 0x07, 0x0a, 0x16, 0xb4, 0x6b, 0x4d, 0x41, 0x44, 0xf7, 0x9b, 0xdd, 0x9d, 0xd0, 0x4a, 0x28, 0x7c }
+};
+
+static bool checkOmac()
+{
+  AESTiny128 aes;
+  OMAC omac;
+  uint32_t hash[4];
+
+  aes.setKey(ctrKey, sizeof(ctrKey));
+  omac.setBlockCipher(&aes);
+  omac.initKey();
+
+  for (int test = 0; test < 2; test++) {
+    omac.init(hash);
+    omac.update(hash, ctrPlaintext, test ? 16 : 0);
+    omac.finalize(hash);
+
+    if (memcmp(hash, cmacTag[test], 16) != 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// test vectors 1, 2, 3 and 6 from the EAX paper
+struct EaxVector {
+  byte key[16];
+  byte nonce[16];
+  byte header[8];
+  byte plaintext[17];
+  byte ciphertext[17];
+  byte tag[16];
+  size_t length;
+};
+
+static const EaxVector eaxVectors[4] = {
+  { { 0x23, 0x39, 0x52, 0xde, 0xe4, 0xd5, 0xed, 0x5f, 0x9b, 0x9c, 0x6d, 0x6f, 0xf8, 0x0f, 0xf4, 0x78 },
+    { 0x62, 0xec, 0x67, 0xf9, 0xc3, 0xa4, 0xa4, 0x07, 0xfc, 0xb2, 0xa8, 0xc4, 0x90, 0x31, 0xa8, 0xb3 },
+    { 0x6b, 0xfb, 0x91, 0x4f, 0xd0, 0x7e, 0xae, 0x6b },
+    { 0 },
+    { 0 },
+    { 0xe0, 0x37, 0x83, 0x0e, 0x83, 0x89, 0xf2, 0x7b, 0x02, 0x5a, 0x2d, 0x65, 0x27, 0xe7, 0x9d, 0x01 },
+    0 },
+  { { 0x91, 0x94, 0x5d, 0x3f, 0x4d, 0xcb, 0xee, 0x0b, 0xf4, 0x5e, 0xf5, 0x22, 0x55, 0xf0, 0x95, 0xa4 },
+    { 0xbe, 0xca, 0xf0, 0x43, 0xb0, 0xa2, 0x3d, 0x84, 0x31, 0x94, 0xba, 0x97, 0x2c, 0x66, 0xde, 0xbd },
+    { 0xfa, 0x3b, 0xfd, 0x48, 0x06, 0xeb, 0x53, 0xfa },
+    { 0xf7, 0xfb },
+    { 0x19, 0xdd },
+    { 0x5c, 0x4c, 0x93, 0x31, 0x04, 0x9d, 0x0b, 0xda, 0xb0, 0x27, 0x74, 0x08, 0xf6, 0x79, 0x67, 0xe5 },
+    2 },
+  { { 0x01, 0xf7, 0x4a, 0xd6, 0x40, 0x77, 0xf2, 0xe7, 0x04, 0xc0, 0xf6, 0x0a, 0xda, 0x3d, 0xd5, 0x23 },
+    { 0x70, 0xc3, 0xdb, 0x4f, 0x0d, 0x26, 0x36, 0x84, 0x00, 0xa1, 0x0e, 0xd0, 0x5d, 0x2b, 0xff, 0x5e },
+    { 0x23, 0x4a, 0x34, 0x63, 0xc1, 0x26, 0x4a, 0xc6 },
+    { 0x1a, 0x47, 0xcb, 0x49, 0x33 },
+    { 0xd8, 0x51, 0xd5, 0xba, 0xe0 },
+    { 0x3a, 0x59, 0xf2, 0x38, 0xa2, 0x3e, 0x39, 0x19, 0x9d, 0xc9, 0x26, 0x66, 0x26, 0xc4, 0x0f, 0x80 },
+    5 },
+  { { 0x7c, 0x77, 0xd6, 0xe8, 0x13, 0xbe, 0xd5, 0xac, 0x98, 0xba, 0xa4, 0x17, 0x47, 0x7a, 0x2e, 0x7d },
+    { 0x1a, 0x8c, 0x98, 0xdc, 0xd7, 0x3d, 0x38, 0x39, 0x3b, 0x2b, 0xf1, 0x56, 0x9d, 0xee, 0xfc, 0x19 },
+    { 0x65, 0xd2, 0x01, 0x79, 0x90, 0xd6, 0x25, 0x28 },
+    { 0x8b, 0x0a, 0x79, 0x30, 0x6c, 0x9c, 0xe7, 0xed, 0x99, 0xda, 0xe4, 0xf8, 0x7f, 0x8d, 0xd6, 0x16,
+      0x36 },
+    { 0x02, 0x08, 0x3e, 0x39, 0x79, 0xda, 0x01, 0x48, 0x12, 0xf5, 0x9f, 0x11, 0xd5, 0x26, 0x30, 0xda,
+      0x30 },
+    { 0x13, 0x73, 0x27, 0xd1, 0x06, 0x49, 0xb0, 0xaa, 0x6e, 0x1c, 0x18, 0x1d, 0xb6, 0x17, 0xd7, 0xf2 },
+    17 }
+};
+
+// encrypt with the encrypt-only AESTiny128, decrypt in place with AES128
+static bool checkEax()
+{
+  EAX<AESTiny128> tiny;
+  EAX<AES128> eax;
+  byte buffer[17];
+  byte tag[16];
+
+  for (int test = 0; test < 4; test++) {
+    const EaxVector& v = eaxVectors[test];
+
+    tiny.setKey(v.key, sizeof(v.key));
+    tiny.setIV(v.nonce, sizeof(v.nonce));
+    tiny.addAuthData(v.header, sizeof(v.header));
+    tiny.encrypt(buffer, v.plaintext, v.length);
+    tiny.computeTag(tag, sizeof(tag));
+
+    if (memcmp(buffer, v.ciphertext, v.length) != 0 || memcmp(tag, v.tag, 16) != 0) {
+      return false;
+    }
+
+    eax.setKey(v.key, sizeof(v.key));
+    eax.setIV(v.nonce, sizeof(v.nonce));
+    eax.addAuthData(v.header, sizeof(v.header));
+    eax.decrypt(buffer, buffer, v.length);
+
+    if (!eax.checkTag(v.tag, 16) || memcmp(buffer, v.plaintext, v.length) != 0) {
+      return false;
+    }
+
+    tag[15] ^= 0x01;
+    eax.setIV(v.nonce, sizeof(v.nonce));
+    eax.addAuthData(v.header, sizeof(v.header));
+    eax.decrypt(buffer, v.ciphertext, v.length);
+
+    if (eax.checkTag(tag, 16)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_CYCLE_COUNTER 1
+#endif
+
+// software ciphers don't touch the virtual clock, so time them for real
+static void throughput(const char* name, BlockCipher& cipher, bool decrypt)
+{
+  const size_t blocks = 65536;
+  byte block[16];
+
+  memset(block, 0x00, sizeof(block));
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#ifdef HAVE_CYCLE_COUNTER
+  unsigned long long startCycles = __rdtsc();
+#endif
+
+  for (size_t i = 0; i < blocks; i++) {
+    if (decrypt) {
+      cipher.decryptBlock(block, block);
+    } else {
+      cipher.encryptBlock(block, block);
+    }
+  }
+
+#ifdef HAVE_CYCLE_COUNTER
+  double cycles = (double)(__rdtsc() - startCycles) / (blocks * 16);
+#else
+  double cycles = 0;
+#endif
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  printf("  %-28s %9.1f MB/s %7.1f cycles/byte\n", name, blocks * 16 / elapsed.count() / 1e6, cycles);
+}
+
+// the same, but handing the cipher a buffer of blocks per call
+static void throughputBlocks(const char* name, BlockCipher& cipher, bool decrypt)
+{
+  const size_t blocks = 65536;
+  const size_t batch = 16;
+  byte buffer[batch * 16];
+
+  memset(buffer, 0x00, sizeof(buffer));
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#ifdef HAVE_CYCLE_COUNTER
+  unsigned long long startCycles = __rdtsc();
+#endif
+
+  for (size_t i = 0; i < blocks; i += batch) {
+    if (decrypt) {
+      cipher.decryptBlocks(buffer, buffer, batch);
+    } else {
+      cipher.encryptBlocks(buffer, buffer, batch);
+    }
+  }
+
+#ifdef HAVE_CYCLE_COUNTER
+  double cycles = (double)(__rdtsc() - startCycles) / (blocks * 16);
+#else
+  double cycles = 0;
+#endif
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  printf("  %-28s %9.1f MB/s %7.1f cycles/byte\n", name, blocks * 16 / elapsed.count() / 1e6, cycles);
+}
+
+// multi-block calls must agree with another implementation block by block,
+// with a count that leaves a partial batch at the end
+static bool checkBlocks(BlockCipher& cipher, BlockCipher& reference)
+{
+  byte key[32];
+  byte input[5 * 16];
+  byte output[5 * 16];
+  byte expected[16];
+
+  for (size_t i = 0; i < sizeof(key); i++) {
+    key[i] = i * 7 + 1;
+  }
+
+  for (size_t i = 0; i < sizeof(input); i++) {
+    input[i] = i * 13 + 5;
+  }
+
+  if (!cipher.setKey(key, cipher.keySize()) || !reference.setKey(key, reference.keySize())) {
+    return false;
+  }
+
+  cipher.encryptBlocks(output, input, 5);
+
+  for (int i = 0; i < 5; i++) {
+    reference.encryptBlock(expected, &input[i * 16]);
+
+    if (memcmp(&output[i * 16], expected, 16) != 0) {
+      return false;
+    }
+  }
+
+  cipher.decryptBlocks(output, output, 5);
+
+  return memcmp(output, input, sizeof(input)) == 0;
+}
+
+static void ghashThroughput(const char* name, bool constantTime)
+{
+  const size_t blocks = 65536;
+  uint32_t H[4];
+  uint32_t Y[4];
+  GHASH ghash;
+  byte buffer[256];
+
+  memset(buffer, 0x5a, sizeof(buffer));
+  memset(Y, 0, sizeof(Y));
+  GF128::mulInit(H, ghashKey);
+  ghash.reset(ghashKey);
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#ifdef HAVE_CYCLE_COUNTER
+  unsigned long long startCycles = __rdtsc();
+#endif
+
+  for (size_t i = 0; i < blocks; i += sizeof(buffer) / 16) {
+    if (constantTime) {
+      for (size_t j = 0; j < sizeof(buffer) / 16; j++) {
+        GF128::mul(Y, H);
+      }
+    } else {
+      ghash.update(buffer, sizeof(buffer));
+    }
+  }
+
+#ifdef HAVE_CYCLE_COUNTER
+  double cycles = (double)(__rdtsc() - startCycles) / (blocks * 16);
+#else
+  double cycles = 0;
+#endif
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  printf("  %-28s %9.1f MB/s %7.1f cycles/byte\n", name, blocks * 16 / elapsed.count() / 1e6, cycles);
+}
+
+// 4 KB messages through the streaming calls or through seal()
+static void gcmThroughput(const char* name, bool oneShot)
+{
+  const size_t messages = 256;
+  GCM<AES128> gcm;
+  byte buffer[4096];
+  byte tag[16];
+
+  memset(buffer, 0x5a, sizeof(buffer));
+  gcm.setKey(gcmKey, sizeof(gcmKey));
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#ifdef HAVE_CYCLE_COUNTER
+  unsigned long long startCycles = __rdtsc();
+#endif
+
+  for (size_t i = 0; i < messages; i++) {
+    if (oneShot) {
+      gcm.seal(-1, gcmIV, sizeof(gcmIV), gcmAuthData, sizeof(gcmAuthData),
+               buffer, buffer, sizeof(buffer), tag, sizeof(tag));
+    } else {
+      gcm.setIV(gcmIV, sizeof(gcmIV));
+      gcm.addAuthData(gcmAuthData, sizeof(gcmAuthData));
+      gcm.encrypt(buffer, buffer, sizeof(buffer));
+      gcm.computeTag(tag, sizeof(tag));
+    }
+  }
+
+#ifdef HAVE_CYCLE_COUNTER
+  double cycles = (double)(__rdtsc() - startCycles) / (messages * sizeof(buffer));
+#else
+  double cycles = 0;
+#endif
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  printf("  %-28s %9.1f MB/s %7.1f cycles/byte\n", name, messages * sizeof(buffer) / elapsed.count() / 1e6, cycles);
+}
+
+// 512 byte sectors, one tweak per sector
+static void xtsThroughput(const char* name, bool decrypt)
+{
+  const size_t sectors = 2048;
+  XTS<AES128> xts;
+  byte buffer[512];
+
+  memset(buffer, 0x5a, sizeof(buffer));
+  xts.setKey(xtsKey[0], sizeof(xtsKey[0]));
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#ifdef HAVE_CYCLE_COUNTER
+  unsigned long long startCycles = __rdtsc();
+#endif
+
+  for (size_t i = 0; i < sectors; i++) {
+    xts.setTweak((const byte*)&i, sizeof(i));
+
+    if (decrypt) {
+      xts.decryptSector(buffer, buffer);
+    } else {
+      xts.encryptSector(buffer, buffer);
+    }
+  }
+
+#ifdef HAVE_CYCLE_COUNTER
+  double cycles = (double)(__rdtsc() - startCycles) / (sectors * sizeof(buffer));
+#else
+  double cycles = 0;
+#endif
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  printf("  %-28s %9.1f MB/s %7.1f cycles/byte\n", name, sectors * sizeof(buffer) / elapsed.count() / 1e6, cycles);
+}
+
+// random lengths and offsets, so the slice-by-4 loop sees every alignment
+// and tail length, hashed in one call and in two pieces
+static bool checkCrc()
+{
+  byte buffer[256];
+  uint32_t seed = 1;
+
+  for (size_t i = 0; i < sizeof(buffer); i++) {
+    seed = seed * 1103515245 + 12345;
+    buffer[i] = seed >> 16;
+  }
+
+  for (int n = 0; n < 10000; n++) {
+    seed = seed * 1103515245 + 12345;
+    size_t offset = (seed >> 16) % 64;
+    seed = seed * 1103515245 + 12345;
+    size_t length = (seed >> 16) % (sizeof(buffer) - offset);
+    size_t split = length ? (seed >> 8) % length : 0;
+    const byte* data = &buffer[offset];
+    uint16_t expected = simCrc16(data, length);
+
+    if (ECCX08Class::crc16Final(ECCX08Class::crc16Update(0, data, length)) != expected ||
+        ECCX08Class::crc16Final(ECCX08Class::crc16Update(ECCX08Class::crc16Update(0, data, split),
+                                                          data + split, length - split)) != expected) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// 67 bytes is the largest packet this library sends
+static void crcThroughput(const char* name, bool bitSerial)
+{
+  const size_t packets = 100000;
+  byte packet[67];
+  uint16_t crc = 0;
+
+  memset(packet, 0x5a, sizeof(packet));
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#ifdef HAVE_CYCLE_COUNTER
+  unsigned long long startCycles = __rdtsc();
+#endif
+
+  for (size_t i = 0; i < packets; i++) {
+    // feed the last result back in so the loop can't be hoisted
+    packet[0] = crc;
+
+    if (bitSerial) {
+      crc = simCrc16(packet, sizeof(packet));
+    } else {
+      crc = ECCX08Class::crc16Final(ECCX08Class::crc16Update(0, packet, sizeof(packet)));
+    }
+  }
+
+#ifdef HAVE_CYCLE_COUNTER
+  double cycles = (double)(__rdtsc() - startCycles) / (packets * sizeof(packet));
+#else
+  double cycles = 0;
+#endif
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  printf("  %-28s %9.1f MB/s %7.1f cycles/byte\n", name, packets * sizeof(packet) / elapsed.count() / 1e6, cycles);
+}
+
+static void run(ECCX08Simulator::Revision revision, bool direct)
+{
+  ECCX08Simulator simulator(revision);
+  ECCX08SimulatorTransport transport(simulator);
+  ECCX08Class wireEccx08(Wire, 0x60);
+  ECCX08Class directEccx08(transport, 0x60);
+  ECCX08Class& eccx08 = direct ? directEccx08 : wireEccx08;
+  bool is608 = (revision == ECCX08Simulator::ATECC608A);
+
+  device = &simulator;
+  Wire.attach(&simulator);
+
+  // FIPS-197 appendix C.1 key in the first block of slot 10
+  static const byte aesKey[16] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+  };
+
+  simulator.setSlot(10, aesKey, sizeof(aesKey));
+  simulator.setLocked(true, true);
+
+  printf("%s over %s\n", is608 ? "ATECC608A" : "ATECC508A", direct ? "ECCX08SimulatorTransport" : "Wire");
+
+  begin();
+  end("begin", eccx08.begin());
+
+  begin();
+  end("serialNumber", eccx08.serialNumber() == "01235E6A72104C91EE");
+
+  byte random[32];
+
+  begin();
+  end("random(32)", eccx08.random(random, sizeof(random)));
+
+  begin();
+  end("random(64 x 4 bytes)", [&]() {
+    for (int i = 0; i < 64; i++) {
+      if (eccx08.random(65536) < 0) {
+        return false;
+      }
+    }
+    return true;
+  }());
+
+  // a second request after instantiating from the bytes 0..47
+  static const byte drbgExpected[64] = {
+    0x04, 0x56, 0x2a, 0xd3, 0x5e, 0x8e, 0xca, 0xfa, 0xaf, 0xda, 0x16, 0x98, 0x1c, 0xda, 0xa1, 0x47,
+    0x60, 0x6b, 0xee, 0xa6, 0x28, 0x01, 0x34, 0x2a, 0xf1, 0x3c, 0x8b, 0x55, 0x35, 0xf7, 0x2f, 0x94,
+    0x95, 0xb7, 0x43, 0x17, 0xc7, 0x62, 0xf0, 0xad, 0xab, 0x7a, 0xbe, 0x71, 0x07, 0x97, 0x61, 0x21,
+    0x76, 0xb6, 0x1b, 0x0e, 0x20, 0x83, 0x98, 0x11, 0x3c, 0xf9, 0xc1, 0x70, 0x15, 0x7b, 0xc7, 0x5f
+  };
+
+  CTRDRBG drbg;
+  byte drbgOutput[4096];
+
+  begin();
+  end("CTRDRBG known answer", [&]() {
+    byte seed[CTRDRBG::SEED_SIZE];
+
+    for (size_t i = 0; i < sizeof(seed); i++) {
+      seed[i] = i;
+    }
+
+    drbg.reseed(seed);
+
+    return drbg.generate(drbgOutput, 64) &&
+           drbg.generate(drbgOutput, 64) &&
+           memcmp(drbgOutput, drbgExpected, 64) == 0;
+  }());
+
+  drbg.clear();
+  eccx08.useDRBG(&drbg);
+
+  begin();
+  end("random(4096) through DRBG", eccx08.random(drbgOutput, sizeof(drbgOutput)));
+
+  eccx08.useDRBG(NULL);
+
+  byte config[128];
+
+  begin();
+  end("readConfiguration", eccx08.readConfiguration(config) && eccx08.locked());
+
+  byte slot8[416];
+  byte readBack[416];
+
+  for (size_t i = 0; i < sizeof(slot8); i++) {
+    slot8[i] = i * 7;
+  }
+
+  begin();
+  end("writeSlot(8, 416)", eccx08.writeSlot(8, slot8, sizeof(slot8)));
+
+  begin();
+  end("readSlot(8, 416)", eccx08.readSlot(8, readBack, sizeof(readBack)) && memcmp(slot8, readBack, sizeof(slot8)) == 0);
+
+  byte publicKey[64];
+  byte signature[64];
+  byte message[32];
+
+  memset(message, 0x5a, sizeof(message));
+
+  begin();
+  end("generatePrivateKey", eccx08.generatePrivateKey(0, publicKey));
+
+  begin();
+  end("ecSign", eccx08.ecSign(0, message, signature));
+
+  begin();
+  end("ecdsaVerify", eccx08.ecdsaVerify(message, signature, publicKey));
+
+  message[0] ^= 0x01;
+
+  begin();
+  end("ecdsaVerify (bad signature)", !eccx08.ecdsaVerify(message, signature, publicKey));
+
+  byte shaInput[150];
+  byte digest[32];
+  byte expected[32];
+
+  for (size_t i = 0; i < sizeof(shaInput); i++) {
+    shaInput[i] = i;
+  }
+
+  simSha256(shaInput, sizeof(shaInput), expected);
+
+  begin();
+  end("SHA-256 (150 bytes)", [&]() {
+    ECCX08Session session(eccx08);
+
+    return eccx08.beginSHA256() &&
+           eccx08.updateSHA256(&shaInput[0]) &&
+           eccx08.updateSHA256(&shaInput[64]) &&
+           eccx08.endSHA256(&shaInput[128], 22, digest) &&
+           memcmp(digest, expected, 32) == 0;
+  }());
+
+  if (!is608) {
+    byte result[16];
+
+    begin();
+    end("aesEncryptECB (unsupported)", eccx08.aesEncryptECB(10, aesPlaintext, result) != 1);
+
+    // a failed batch reports it and leaves no plaintext behind
+    begin();
+    end("slot encryptBlocks (508A)", [&]() {
+      AES128 aes;
+      byte blocks[2 * 16];
+
+      memcpy(blocks, aesPlaintext, 16);
+      memcpy(&blocks[16], aesPlaintext, 16);
+      aes.setKeySlot(10);
+
+      if (aes.encryptBlocks(blocks, blocks, 2)) {
+        return false;
+      }
+
+      for (size_t i = 0; i < sizeof(blocks); i++) {
+        if (blocks[i] != 0) {
+          return false;
+        }
+      }
+      return true;
+    }());
+
+    // GFM is an AES mode, so the multiply fails and the token says so
+    begin();
+    end("GHASH on the chip (508A)", [&]() {
+      GHASH ghash;
+      byte token[16];
+
+      memset(token, 0xff, sizeof(token));
+      ghash.useChip(true);
+      ghash.reset(ghashKey);
+      ghash.update(ghashInput, sizeof(ghashInput));
+
+      if (ghash.finalize(token, sizeof(token))) {
+        return false;
+      }
+
+      for (size_t i = 0; i < sizeof(token); i++) {
+        if (token[i] != 0) {
+          return false;
+        }
+      }
+      return true;
+    }());
+
+    begin();
+    end("GCM seal on slot (508A)", [&]() {
+      GCM<AES128> gcm;
+      byte buffer[32];
+      byte tag[16];
+
+      memset(tag, 0xff, sizeof(tag));
+
+      if (gcm.seal(10, gcmIV, sizeof(gcmIV), 0, 0, buffer, gcmPlaintext, sizeof(buffer), tag, sizeof(tag))) {
+        return false;
+      }
+
+      for (size_t i = 0; i < sizeof(buffer); i++) {
+        if (buffer[i] != 0 || (i < sizeof(tag) && tag[i] != 0)) {
+          return false;
+        }
+      }
+      return !gcm.checkTag(tag, sizeof(tag));
+    }());
+
+    // the AES is never given a key, so it stays on slot 0 of the chip
+    begin();
+    end("GCM on AES slot 0 (508A)", [&]() {
+      GCM<AES128> gcm;
+      byte buffer[32];
+      byte tag[16];
+
+      memset(tag, 0xff, sizeof(tag));
+
+      if (gcm.seal(-1, gcmIV, sizeof(gcmIV), 0, 0, buffer, gcmPlaintext, sizeof(buffer), tag, sizeof(tag))) {
+        return false;
+      }
+
+      for (size_t i = 0; i < sizeof(buffer); i++) {
+        if (buffer[i] != 0 || (i < sizeof(tag) && tag[i] != 0)) {
+          return false;
+        }
+      }
+      return true;
+    }());
+
+    begin();
+    end("CTR on AES slot 0 (508A)", [&]() {
+      CTR<AES128> ctr;
+      byte packet[20];
+
+      ctr.setIV(ctrIV, sizeof(ctrIV));
+      ctr.encrypt(packet, ctrPlaintext, sizeof(packet));
+
+      for (size_t i = 0; i < sizeof(packet); i++) {
+        if (packet[i] != 0) {
+          return false;
+        }
+      }
+      return ctr.available() == 0;
+    }());
+
+    begin();
+    end("XTS on AES slot 0 (508A)", [&]() {
+      XTS<AES128> xts;
+      byte sector[32];
+
+      xts.setSectorSize(sizeof(sector));
+
+      if (xts.setTweak(xtsTweak[0], sizeof(xtsTweak[0])) || xts.encryptSector(sector, ctrPlaintext)) {
+        return false;
+      }
+
+      for (size_t i = 0; i < sizeof(sector); i++) {
+        if (sector[i] != 0) {
+          return false;
+        }
+      }
+      return true;
+    }());
+
+    begin();
+    end("GCM session key (508A)", [&]() {
+      static const byte context[4] = {'t', 'e', 's', 't'};
+      GCM<AES128> gcm;
+
+      return !gcm.setSessionKey(10, context, sizeof(context));
+    }());
+
+    begin();
+    end("CTR on slot (508A)", [&]() {
+      CTR<AES128> ctr;
+      byte packet[20];
+
+      ctr.setKeySlot(10);
+      ctr.setIV(ctrIV, sizeof(ctrIV));
+
+      if (ctr.precompute() != 0) {
+        return false;
+      }
+
+      ctr.encrypt(packet, ctrPlaintext, sizeof(packet));
+
+      for (size_t i = 0; i < sizeof(packet); i++) {
+        if (packet[i] != 0) {
+          return false;
+        }
+      }
+      return true;
+    }());
+
+    begin();
+    end("XTS on slot (508A)", [&]() {
+      XTS<AES128> xts;
+      byte sector[32];
+
+      xts.setKeySlots(10, 10);
+      xts.setSectorSize(sizeof(sector));
+      xts.setTweak(xtsTweak[0], sizeof(xtsTweak[0]));
+
+      if (xts.encryptSector(sector, ctrPlaintext)) {
+        return false;
+      }
+
+      for (size_t i = 0; i < sizeof(sector); i++) {
+        if (sector[i] != 0) {
+          return false;
+        }
+      }
+      return true;
+    }());
+    return;
+  }
+
+  byte block[16];
+  byte plain[16];
+
+  begin();
+  end("aesEncryptECB", eccx08.aesEncryptECB(10, aesPlaintext, block) == 1 && memcmp(block, aesCiphertext[0], 16) == 0);
+
+  begin();
+  end("aesDecryptECB", eccx08.aesDecryptECB(10, block, plain) == 1 && memcmp(plain, aesPlaintext, 16) == 0);
+
+  byte product[16];
+
+  simGf128Multiply(aesPlaintext, aesCiphertext[0], expected);
+
+  begin();
+  end("aesMultiply", eccx08.aesMultiply(10, aesPlaintext, aesCiphertext[0], product) == 1 && memcmp(product, expected, 16) == 0);
+
+  begin();
+  end("aesEncryptECB x 16", [&]() {
+    for (int i = 0; i < 16; i++) {
+      if (eccx08.aesEncryptECB(10, aesPlaintext, block) != 1) {
+        return false;
+      }
+    }
+    return true;
+  }());
+
+  begin();
+  end("aesEncryptECB x 16 (session)", [&]() {
+    ECCX08Session session(eccx08);
+
+    for (int i = 0; i < 16; i++) {
+      if (eccx08.aesEncryptECB(10, aesPlaintext, block) != 1) {
+        return false;
+      }
+    }
+    return true;
+  }());
+
+  begin();
+  end("aesEncryptECB(16 blocks)", [&]() {
+    byte input[16 * 16];
+    byte output[16 * 16];
+    byte expected[16];
+
+    for (size_t i = 0; i < sizeof(input); i++) {
+      input[i] = i * 7 + 3;
+    }
+
+    if (eccx08.aesEncryptECB(10, input, output, 16) != 1) {
+      return false;
+    }
+
+    for (int i = 0; i < 16; i++) {
+      simAes128Encrypt(aesKey, &input[i * 16], expected);
+
+      if (memcmp(&output[i * 16], expected, 16) != 0) {
+        return false;
+      }
+    }
+
+    return eccx08.aesDecryptECB(10, output, output, 16) == 1 && memcmp(output, input, sizeof(input)) == 0;
+  }());
+
+  begin();
+  end("AES128 slot encryptBlocks", [&]() {
+    AES128 aes;
+    byte blocks[4 * 16];
+
+    for (int i = 0; i < 4; i++) {
+      memcpy(&blocks[i * 16], aesPlaintext, 16);
+    }
+
+    aes.setKeySlot(10);
+
+    if (!aes.encryptBlocks(blocks, blocks, 4)) {
+      return false;
+    }
+
+    for (int i = 0; i < 4; i++) {
+      if (memcmp(&blocks[i * 16], aesCiphertext[0], 16) != 0) {
+        return false;
+      }
+    }
+    return true;
+  }());
+
+  // a cleared cipher has no key, rather than falling back to slot 0
+  begin();
+  end("AES128 encryptBlocks, cleared", [&]() {
+    AES128 aes;
+    byte blocks[2 * 16];
+
+    aes.setKey(aesKey, sizeof(aesKey));
+    aes.clear();
+    memcpy(blocks, aesPlaintext, 16);
+    memcpy(&blocks[16], aesPlaintext, 16);
+
+    if (aes.encryptBlocks(blocks, blocks, 2)) {
+      return false;
+    }
+
+    for (size_t i = 0; i < sizeof(blocks); i++) {
+      if (blocks[i] != 0) {
+        return false;
+      }
+    }
+    return device->stats().commands == startStats.commands;
+  }());
+
+  begin();
+  end("GHASH on the chip (2 blocks)", checkGhash(true));
+
+  begin();
+  end("GCM on slot 10, 2 messages", [&]() {
+    GCM<AES128> chip;
+    GCM<AES128> software;
+    byte buffer[32];
+    byte expected[32];
+    byte tag[16];
+    byte expectedTag[16];
+
+    software.setKey(aesKey, sizeof(aesKey));
+
+    // the first setIV() encrypts H and the counter, the second only the counter;
+    // the two counter blocks of each message share one wake
+    for (int n = 0; n < 2; n++) {
+      chip.setIV(10, gcmIV, sizeof(gcmIV));
+      chip.encrypt(10, buffer, gcmPlaintext, sizeof(buffer));
+      chip.computeTag(tag, sizeof(tag));
+
+      software.setIV(gcmIV, sizeof(gcmIV));
+      software.encrypt(expected, gcmPlaintext, sizeof(expected));
+      software.computeTag(expectedTag, sizeof(expectedTag));
+
+      if (memcmp(buffer, expected, sizeof(buffer)) != 0 || memcmp(tag, expectedTag, 16) != 0) {
+        return false;
+      }
+    }
+    return device->stats().commands - startStats.commands == 7 &&
+           device->stats().wakes - startStats.wakes == 5;
+  }());
+
+  begin();
+  end("GCM session key, 4 x 4 KB", [&]() {
+    static const byte context[8] = {'s', 'e', 's', 's', 'i', 'o', 'n', '1'};
+    GCM<AES128> hybrid;
+    GCM<AES128> software;
+    byte input[16];
+    byte sessionKey[16];
+    byte buffer[4096];
+    byte expected[4096];
+    byte tag[16];
+    byte expectedTag[16];
+
+    // one chip command, then everything runs in software
+    if (!hybrid.setSessionKey(10, context, sizeof(context))) {
+      return false;
+    }
+
+    memset(buffer, 0x5a, sizeof(buffer));
+    memset(expected, 0x5a, sizeof(expected));
+
+    for (int n = 0; n < 4; n++) {
+      hybrid.seal(-1, gcmIV, sizeof(gcmIV), 0, 0, buffer, buffer, sizeof(buffer), tag, sizeof(tag));
+    }
+
+    // block 1 of the session key is E(K, 01 || 08 || context || 00.. || 10)
+    memset(input, 0, sizeof(input));
+    input[0] = 1;
+    input[1] = sizeof(context);
+    memcpy(&input[2], context, sizeof(context));
+    input[15] = sizeof(sessionKey);
+    simAes128Encrypt(aesKey, input, sessionKey);
+    software.setKey(sessionKey, sizeof(sessionKey));
+
+    for (int n = 0; n < 4; n++) {
+      software.seal(-1, gcmIV, sizeof(gcmIV), 0, 0, expected, expected, sizeof(expected), expectedTag, sizeof(expectedTag));
+    }
+
+    return memcmp(buffer, expected, sizeof(buffer)) == 0 && memcmp(tag, expectedTag, 16) == 0 &&
+           device->stats().commands - startStats.commands == 1;
+  }());
+
+  // contexts that differ only in a trailing zero byte give different keys
+  begin();
+  end("GCM session key contexts", [&]() {
+    static const byte context[3] = {'a', 'b', 0};
+    GCM<AES128> first;
+    GCM<AES128> second;
+    byte tag[16];
+    byte otherTag[16];
+
+    if (!first.setSessionKey(10, context, 2) || !second.setSessionKey(10, context, 3)) {
+      return false;
+    }
+
+    first.seal(-1, gcmIV, sizeof(gcmIV), 0, 0, 0, 0, 0, tag, sizeof(tag));
+    second.seal(-1, gcmIV, sizeof(gcmIV), 0, 0, 0, 0, 0, otherTag, sizeof(otherTag));
+
+    return memcmp(tag, otherTag, 16) != 0;
+  }());
+
+  CTR<AES128> ctr;
+  CTR<AES128> expectedCtr;
+
+  ctr.setKeySlot(10);
+  ctr.setIV(ctrIV, sizeof(ctrIV));
+  expectedCtr.setKey(aesKey, sizeof(aesKey));
+  expectedCtr.setIV(ctrIV, sizeof(ctrIV));
+
+  // the four blocks go to the chip in one wake
+  begin();
+  end("CTR on slot 10, precompute",
+      ctr.precompute() == 64 && device->stats().wakes - startStats.wakes == 1);
+
+  // the packet is then only an XOR, with no chip traffic
+  begin();
+  end("CTR on slot 10, 48 byte packet", [&]() {
+    byte packet[48];
+    byte expected[48];
+
+    ctr.encrypt(packet, ctrPlaintext, sizeof(packet));
+    expectedCtr.encrypt(expected, ctrPlaintext, sizeof(expected));
+
+    return memcmp(packet, expected, sizeof(packet)) == 0 && ctr.available() == 16 &&
+           device->stats().commands == startStats.commands;
+  }());
+
+  // a key change drops the unused keystream and rewinds the counter to match
+  begin();
+  end("CTR key change, precomputed", [&]() {
+    byte packet[37];
+    byte expected[37];
+
+    ctr.encrypt(packet, ctrPlaintext, 5);
+    expectedCtr.encrypt(expected, ctrPlaintext, 5);
+    ctr.precompute();
+
+    ctr.setKey(aesKey, sizeof(aesKey));
+    expectedCtr.setKey(aesKey, sizeof(aesKey));
+    ctr.encrypt(&packet[5], &ctrPlaintext[5], 32);
+    expectedCtr.encrypt(&expected[5], &ctrPlaintext[5], 32);
+
+    return memcmp(packet, expected, sizeof(packet)) == 0;
+  }());
+
+  begin();
+  end("XTS slot 10, 32 byte sector", [&]() {
+    XTS<AES128> chip;
+    XTS<AES128> software;
+    byte key[32];
+    byte sector[32];
+    byte expected[32];
+
+    // real use wants different data and tweak keys; the bench only has one
+    memcpy(key, aesKey, 16);
+    memcpy(&key[16], aesKey, 16);
+    software.setKey(key, sizeof(key));
+    software.setSectorSize(sizeof(sector));
+    software.setTweak(xtsTweak[0], sizeof(xtsTweak[0]));
+    software.encryptSector(expected, ctrPlaintext);
+
+    // the tweak and both blocks share one wake
+    chip.setKeySlots(10, 10);
+    chip.setSectorSize(sizeof(sector));
+    chip.setTweak(xtsTweak[0], sizeof(xtsTweak[0]));
+
+    return chip.encryptSector(sector, ctrPlaintext) &&
+           memcmp(sector, expected, sizeof(sector)) == 0 &&
+           device->stats().commands - startStats.commands == 3 &&
+           device->stats().wakes - startStats.wakes == 1;
+  }());
+
+  // ciphertext stealing, decrypted in place with the tweak already encrypted
+  begin();
+  end("XTS slot 10, 40 byte sector", [&]() {
+    XTS<AES128> chip;
+    XTS<AES128> software;
+    byte key[32];
+    byte sector[40];
+
+    memcpy(key, aesKey, 16);
+    memcpy(&key[16], aesKey, 16);
+    software.setKey(key, sizeof(key));
+    software.setSectorSize(sizeof(sector));
+    software.setTweak(xtsTweak[0], sizeof(xtsTweak[0]));
+    software.encryptSector(sector, ctrPlaintext);
+
+    chip.setKeySlots(10, 10);
+    chip.setSectorSize(sizeof(sector));
+    chip.setTweak(xtsTweak[0], sizeof(xtsTweak[0]));
+
+    if (!chip.decryptSector(sector, sector) || memcmp(sector, ctrPlaintext, sizeof(sector)) != 0) {
+      return false;
+    }
+
+    return chip.encryptSector(sector, sector) && software.decryptSector(sector, sector) &&
+           memcmp(sector, ctrPlaintext, sizeof(sector)) == 0 &&
+           device->stats().commands - startStats.commands == 7 &&
+           device->stats().wakes - startStats.wakes == 2;
+  }());
+
+  begin();
+  end("submitAes + poll", [&]() {
+    int handle = eccx08.submitAes(0x00, 10, aesPlaintext);
+    int result;
+
+    while ((result = eccx08.poll(handle, block)) == 0) {
+      delayMicroseconds(50);
+    }
+
+    return result == 1 && memcmp(block, aesCiphertext[0], 16) == 0;
+  }());
+}
+
+static void software()
+{
+  AES128 aes128;
+  AES192 aes192;
+  AES256 aes256;
+  AESBitsliced128 bitsliced128;
+  AESBitsliced256 bitsliced256;
+
+  printf("software\n");
+
+  if (!checkCipher(aes128, aesCiphertext[0]) ||
+      !checkCipher(aes192, aesCiphertext[1]) ||
+      !checkCipher(aes256, aesCiphertext[2])) {
+    printf("  AES known answers FAILED\n");
+    failures++;
+  }
+
+  if (!checkCipher(bitsliced128, aesCiphertext[0]) ||
+      !checkCipher(bitsliced256, aesCiphertext[2]) ||
+      !checkBlocks(bitsliced128, aes128) ||
+      !checkBlocks(bitsliced256, aes256) ||
+      !checkBlocks(aes128, bitsliced128) ||
+      !checkBlocks(aes256, bitsliced256)) {
+    printf("  bitsliced and multi-block AES checks FAILED\n");
+    failures++;
+  }
+
+  GCM<AES128> gcm;
+
+  if (!checkGcm(gcm)) {
+    printf("  GCM known answers FAILED\n");
+    failures++;
+  }
+
+  if (!checkCtr()) {
+    printf("  CTR known answers FAILED\n");
+    failures++;
+  }
+
+  if (!checkXts()) {
+    printf("  XTS known answers FAILED\n");
+    failures++;
+  }
+
+  if (!checkOmac() || !checkEax()) {
+    printf("  OMAC and EAX known answers FAILED\n");
+    failures++;
+  }
+
+  if (!checkCrc()) {
+    printf("  CRC-16 checks FAILED\n");
+    failures++;
+  }
+
+  if (!checkGf128()) {
+    printf("  GF(2^128) multiply checks FAILED\n");
+    failures++;
+  }
+
+#if defined(CRYPTO_AES_AESNI)
+  if (__builtin_cpu_supports("aes")) {
+    printf("  (AES-NI)\n");
+  } else {
+    printf("  (T-table AES, no AES-NI on this CPU)\n");
+  }
+#elif defined(CRYPTO_AES_TTABLE)
+  printf("  (T-table AES)\n");
+#else
+  printf("  (byte oriented AES)\n");
+#endif
+
+  throughput("AES128 encryptBlock", aes128, false);
+  throughput("AES128 decryptBlock", aes128, true);
+  throughputBlocks("AES128 encryptBlocks", aes128, false);
+  throughputBlocks("AES128 decryptBlocks", aes128, true);
+  throughput("AES256 encryptBlock", aes256, false);
+  throughput("AES256 decryptBlock", aes256, true);
+  throughputBlocks("AES256 encryptBlocks", aes256, false);
+  throughputBlocks("AES256 decryptBlocks", aes256, true);
+  throughput("Bitsliced128 encryptBlock", bitsliced128, false);
+  throughputBlocks("Bitsliced128 encryptBlocks", bitsliced128, false);
+  throughput("Bitsliced128 decryptBlock", bitsliced128, true);
+  throughputBlocks("Bitsliced128 decryptBlocks", bitsliced128, true);
+  throughputBlocks("Bitsliced256 encryptBlocks", bitsliced256, false);
+  ghashThroughput("GHASH update", false);
+  ghashThroughput("GF128::mul", true);
+  gcmThroughput("GCM encrypt (4 KB)", false);
+  gcmThroughput("GCM seal (4 KB)", true);
+  xtsThroughput("XTS encryptSector (512)", false);
+  xtsThroughput("XTS decryptSector (512)", true);
+  crcThroughput("CRC-16 bit serial", true);
+  crcThroughput("CRC-16 crc16Update", false);
+}
+
+int main(int argc, char* argv[])
+{
+  // "bench software" skips the device runs, for comparing AES builds
+  if (argc < 2 || strcmp(argv[1], "software") != 0) {
+    run(ECCX08Simulator::ATECC508A, false);
+    run(ECCX08Simulator::ATECC608A, false);
+    run(ECCX08Simulator::ATECC608A, true);
+  }
+
+  software();
+
+  if (failures) {
+    printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+
+  return 0;
+}
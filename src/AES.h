@@ -32,6 +32,19 @@
 #define CRYPTO_AES_DEFAULT 1
 #endif
 
+// 32-bit targets run AES128/192/256 on word oriented T-tables.  AVR keeps
+// the byte oriented code, which suits its registers and flash better.
+// Define CRYPTO_AES_BYTEWISE to use the byte oriented code everywhere.
+#if defined(CRYPTO_AES_DEFAULT) && !defined(__AVR__) && !defined(CRYPTO_AES_BYTEWISE)
+#define CRYPTO_AES_TTABLE 1
+#endif
+
+// x86-64 hosts switch to the AES-NI instructions at runtime when cpuid
+// reports them.  Define CRYPTO_AES_NO_AESNI to stay on the T-tables.
+#if defined(CRYPTO_AES_TTABLE) && defined(__x86_64__) && defined(__GNUC__) && !defined(CRYPTO_AES_NO_AESNI)
+#define CRYPTO_AES_AESNI 1
+#endif
+
 #if defined(CRYPTO_AES_DEFAULT) || defined(CRYPTO_DOC)
 
 class AESTiny128;
@@ -49,9 +62,14 @@ public:
     void encryptBlock(uint8_t *output, const uint8_t *input);
     void decryptBlock(uint8_t *output, const uint8_t *input);
 
+    bool encryptBlocks(uint8_t *output, const uint8_t *input, size_t count);
+    bool decryptBlocks(uint8_t *output, const uint8_t *input, size_t count);
+
     void encryptBlockWithSlot(int slot, uint8_t *output, const uint8_t *input);
     void decryptBlockWithSlot(int slot, uint8_t *output, const uint8_t *input);
 
+    void setKeySlot(int slot);
+
     void clear();
 
 protected:
@@ -59,6 +77,8 @@ protected:
 
     /** @cond aes_internal */
     uint8_t rounds;
+    int8_t slot;
+    bool keyed;
     uint8_t *schedule;
 
     static void subBytesAndShiftRows(uint8_t *output, const uint8_t *input);
@@ -195,6 +215,63 @@ private:
     uint8_t reverse[16];
 };
 
+class AESBitslicedCommon : public BlockCipher
+{
+public:
+    virtual ~AESBitslicedCommon();
+
+    size_t blockSize() const;
+
+    void encryptBlock(uint8_t *output, const uint8_t *input);
+    void decryptBlock(uint8_t *output, const uint8_t *input);
+
+    bool encryptBlocks(uint8_t *output, const uint8_t *input, size_t count);
+    bool decryptBlocks(uint8_t *output, const uint8_t *input, size_t count);
+
+    void encryptBlockWithSlot(int slot, uint8_t *output, const uint8_t *input);
+    void decryptBlockWithSlot(int slot, uint8_t *output, const uint8_t *input);
+
+    void clear();
+
+protected:
+    AESBitslicedCommon();
+
+    /** @cond aes_internal */
+    uint8_t rounds;
+    uint32_t *schedule;
+
+    void expandKey(const uint8_t *key, size_t len);
+    /** @endcond */
+};
+
+class AESBitsliced128 : public AESBitslicedCommon
+{
+public:
+    AESBitsliced128();
+    virtual ~AESBitsliced128();
+
+    size_t keySize() const;
+
+    bool setKey(const uint8_t *key, size_t len);
+
+private:
+    uint32_t sched[88];
+};
+
+class AESBitsliced256 : public AESBitslicedCommon
+{
+public:
+    AESBitsliced256();
+    virtual ~AESBitsliced256();
+
+    size_t keySize() const;
+
+    bool setKey(const uint8_t *key, size_t len);
+
+private:
+    uint32_t sched[120];
+};
+
 #endif // CRYPTO_AES_DEFAULT
 
 #if defined(CRYPTO_AES_ESP32)
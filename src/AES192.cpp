@@ -96,6 +96,8 @@ bool AES192::setKey(const uint8_t *key, size_t len)
         ++w;
     }
 
+    slot = -1;
+    keyed = true;
     return true;
 }
 
@@ -103,6 +103,8 @@ bool AES256::setKey(const uint8_t *key, size_t len)
         ++w;
     }
 
+    slot = -1;
+    keyed = true;
     return true;
 }
 
@@ -274,6 +276,14 @@ void AESTiny256::decryptBlock(uint8_t *output, const uint8_t *input)
     // Decryption is not supported by AESTiny256.
 }
 
+void AESTiny256::encryptBlockWithSlot(int slot, uint8_t *output, const uint8_t *input)
+{
+}
+
+void AESTiny256::decryptBlockWithSlot(int slot, uint8_t *output, const uint8_t *input)
+{
+}
+
 void AESTiny256::clear()
 {
     clean(schedule);
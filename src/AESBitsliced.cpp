@@ -0,0 +1,704 @@
+/*
+ * Copyright (C) 2026 Operator Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * The bitsliced S-box, orthogonalization, key schedule and round functions
+ * are derived from BearSSL's aes_ct.c, aes_ct_enc.c and aes_ct_dec.c:
+ *
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "AES.h"
+#include "Crypto.h"
+#include "ArduinoECCX08.h"
+#include <string.h>
+
+#if defined(CRYPTO_AES_DEFAULT) || defined(CRYPTO_DOC)
+
+/**
+ * \class AESBitslicedCommon AES.h <AES.h>
+ * \brief Abstract base class for constant-time bitsliced AES.
+ *
+ * The AESCommon classes look up S-box and T-table entries by secret
+ * indexes, which leaks key material through cache and flash timing on
+ * parts that have a cache or a flash accelerator.  This implementation
+ * follows the 32-bit "ct" design from BearSSL instead: two blocks are
+ * spread over eight 32-bit words, one bit of every byte per word, and
+ * SubBytes is evaluated as a fixed boolean circuit.  There are no
+ * data-dependent branches or memory accesses.
+ *
+ * Because two blocks are processed for the price of one, encryptBlocks()
+ * and decryptBlocks() are the efficient entry points.  Modes such as
+ * CTR and GCM that can generate several keystream blocks ahead of time
+ * should use them.
+ *
+ * Decryption is supported, using the same schedule as encryption.
+ *
+ * \sa AESBitsliced128, AESBitsliced256, AESCommon
+ */
+
+/**
+ * \class AESBitsliced128 AES.h <AES.h>
+ * \brief Constant-time bitsliced AES block cipher with 128-bit keys.
+ *
+ * \sa AESBitsliced256, AES128
+ */
+
+/**
+ * \class AESBitsliced256 AES.h <AES.h>
+ * \brief Constant-time bitsliced AES block cipher with 256-bit keys.
+ *
+ * \sa AESBitsliced128, AES256
+ */
+
+/** @cond aes_bitsliced */
+
+// Evaluates the AES S-box on all 32 bytes of a bitsliced state with the
+// Boyar-Peralta circuit.  q[0] holds the least significant bit of every byte.
+static void bitsliceSbox(uint32_t *q)
+{
+    uint32_t x0, x1, x2, x3, x4, x5, x6, x7;
+    uint32_t y1, y2, y3, y4, y5, y6, y7, y8, y9;
+    uint32_t y10, y11, y12, y13, y14, y15, y16, y17, y18, y19;
+    uint32_t y20, y21;
+    uint32_t z0, z1, z2, z3, z4, z5, z6, z7, z8, z9;
+    uint32_t z10, z11, z12, z13, z14, z15, z16, z17;
+    uint32_t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;
+    uint32_t t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+    uint32_t t20, t21, t22, t23, t24, t25, t26, t27, t28, t29;
+    uint32_t t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+    uint32_t t40, t41, t42, t43, t44, t45, t46, t47, t48, t49;
+    uint32_t t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+    uint32_t t60, t61, t62, t63, t64, t65, t66, t67;
+    uint32_t s0, s1, s2, s3, s4, s5, s6, s7;
+
+    x0 = q[7];
+    x1 = q[6];
+    x2 = q[5];
+    x3 = q[4];
+    x4 = q[3];
+    x5 = q[2];
+    x6 = q[1];
+    x7 = q[0];
+
+    // Top linear transformation.
+    y14 = x3 ^ x5;
+    y13 = x0 ^ x6;
+    y9 = x0 ^ x3;
+    y8 = x0 ^ x5;
+    t0 = x1 ^ x2;
+    y1 = t0 ^ x7;
+    y4 = y1 ^ x3;
+    y12 = y13 ^ y14;
+    y2 = y1 ^ x0;
+    y5 = y1 ^ x6;
+    y3 = y5 ^ y8;
+    t1 = x4 ^ y12;
+    y15 = t1 ^ x5;
+    y20 = t1 ^ x1;
+    y6 = y15 ^ x7;
+    y10 = y15 ^ t0;
+    y11 = y20 ^ y9;
+    y7 = x7 ^ y11;
+    y17 = y10 ^ y11;
+    y19 = y10 ^ y8;
+    y16 = t0 ^ y11;
+    y21 = y13 ^ y16;
+    y18 = x0 ^ y16;
+
+    // Non-linear section.
+    t2 = y12 & y15;
+    t3 = y3 & y6;
+    t4 = t3 ^ t2;
+    t5 = y4 & x7;
+    t6 = t5 ^ t2;
+    t7 = y13 & y16;
+    t8 = y5 & y1;
+    t9 = t8 ^ t7;
+    t10 = y2 & y7;
+    t11 = t10 ^ t7;
+    t12 = y9 & y11;
+    t13 = y14 & y17;
+    t14 = t13 ^ t12;
+    t15 = y8 & y10;
+    t16 = t15 ^ t12;
+    t17 = t4 ^ t14;
+    t18 = t6 ^ t16;
+    t19 = t9 ^ t14;
+    t20 = t11 ^ t16;
+    t21 = t17 ^ y20;
+    t22 = t18 ^ y19;
+    t23 = t19 ^ y21;
+    t24 = t20 ^ y18;
+
+    t25 = t21 ^ t22;
+    t26 = t21 & t23;
+    t27 = t24 ^ t26;
+    t28 = t25 & t27;
+    t29 = t28 ^ t22;
+    t30 = t23 ^ t24;
+    t31 = t22 ^ t26;
+    t32 = t31 & t30;
+    t33 = t32 ^ t24;
+    t34 = t23 ^ t33;
+    t35 = t27 ^ t33;
+    t36 = t24 & t35;
+    t37 = t36 ^ t34;
+    t38 = t27 ^ t36;
+    t39 = t29 & t38;
+    t40 = t25 ^ t39;
+
+    t41 = t40 ^ t37;
+    t42 = t29 ^ t33;
+    t43 = t29 ^ t40;
+    t44 = t33 ^ t37;
+    t45 = t42 ^ t41;
+    z0 = t44 & y15;
+    z1 = t37 & y6;
+    z2 = t33 & x7;
+    z3 = t43 & y16;
+    z4 = t40 & y1;
+    z5 = t29 & y7;
+    z6 = t42 & y11;
+    z7 = t45 & y17;
+    z8 = t41 & y10;
+    z9 = t44 & y12;
+    z10 = t37 & y3;
+    z11 = t33 & y4;
+    z12 = t43 & y13;
+    z13 = t40 & y5;
+    z14 = t29 & y2;
+    z15 = t42 & y9;
+    z16 = t45 & y14;
+    z17 = t41 & y8;
+
+    // Bottom linear transformation.
+    t46 = z15 ^ z16;
+    t47 = z10 ^ z11;
+    t48 = z5 ^ z13;
+    t49 = z9 ^ z10;
+    t50 = z2 ^ z12;
+    t51 = z2 ^ z5;
+    t52 = z7 ^ z8;
+    t53 = z0 ^ z3;
+    t54 = z6 ^ z7;
+    t55 = z16 ^ z17;
+    t56 = z12 ^ t48;
+    t57 = t50 ^ t53;
+    t58 = z4 ^ t46;
+    t59 = z3 ^ t54;
+    t60 = t46 ^ t57;
+    t61 = z14 ^ t57;
+    t62 = t52 ^ t58;
+    t63 = t49 ^ t58;
+    t64 = z4 ^ t59;
+    t65 = t61 ^ t62;
+    t66 = z1 ^ t63;
+    s0 = t59 ^ t63;
+    s6 = t56 ^ ~t62;
+    s7 = t48 ^ ~t60;
+    t67 = t64 ^ t65;
+    s3 = t53 ^ t66;
+    s4 = t51 ^ t66;
+    s5 = t47 ^ t65;
+    s1 = t64 ^ ~s3;
+    s2 = t55 ^ ~t67;
+
+    q[7] = s0;
+    q[6] = s1;
+    q[5] = s2;
+    q[4] = s3;
+    q[3] = s4;
+    q[2] = s5;
+    q[1] = s6;
+    q[0] = s7;
+}
+
+// Applies the inverse of the affine transformation that follows inversion
+// in the S-box.  InvSubBytes(x) is this, then SubBytes, then this again.
+static void bitsliceInverseAffine(uint32_t *q)
+{
+    uint32_t q0, q1, q2, q3, q4, q5, q6, q7;
+
+    q0 = ~q[0];
+    q1 = ~q[1];
+    q2 = q[2];
+    q3 = q[3];
+    q4 = q[4];
+    q5 = ~q[5];
+    q6 = ~q[6];
+    q7 = q[7];
+    q[7] = q1 ^ q4 ^ q6;
+    q[6] = q0 ^ q3 ^ q5;
+    q[5] = q7 ^ q2 ^ q4;
+    q[4] = q6 ^ q1 ^ q3;
+    q[3] = q5 ^ q0 ^ q2;
+    q[2] = q4 ^ q7 ^ q1;
+    q[1] = q3 ^ q6 ^ q0;
+    q[0] = q2 ^ q5 ^ q7;
+}
+
+static void bitsliceInverseSbox(uint32_t *q)
+{
+    bitsliceInverseAffine(q);
+    bitsliceSbox(q);
+    bitsliceInverseAffine(q);
+}
+
+// Converts between eight words holding two interleaved blocks and the
+// bitsliced representation.  The transform is its own inverse.
+#define SWAPN(cl, ch, s, x, y) \
+    do { \
+        uint32_t a = (x); \
+        uint32_t b = (y); \
+        (x) = (a & (cl)) | ((b & (cl)) << (s)); \
+        (y) = ((a & (ch)) >> (s)) | (b & (ch)); \
+    } while (0)
+#define SWAP2(x, y) SWAPN(0x55555555U, 0xAAAAAAAAU, 1, x, y)
+#define SWAP4(x, y) SWAPN(0x33333333U, 0xCCCCCCCCU, 2, x, y)
+#define SWAP8(x, y) SWAPN(0x0F0F0F0FU, 0xF0F0F0F0U, 4, x, y)
+
+static void ortho(uint32_t *q)
+{
+    SWAP2(q[0], q[1]);
+    SWAP2(q[2], q[3]);
+    SWAP2(q[4], q[5]);
+    SWAP2(q[6], q[7]);
+
+    SWAP4(q[0], q[2]);
+    SWAP4(q[1], q[3]);
+    SWAP4(q[4], q[6]);
+    SWAP4(q[5], q[7]);
+
+    SWAP8(q[0], q[4]);
+    SWAP8(q[1], q[5]);
+    SWAP8(q[2], q[6]);
+    SWAP8(q[3], q[7]);
+}
+
+static inline uint32_t loadWord(const uint8_t *in)
+{
+    return ((uint32_t)(in[0])) |
+           (((uint32_t)(in[1])) << 8) |
+           (((uint32_t)(in[2])) << 16) |
+           (((uint32_t)(in[3])) << 24);
+}
+
+static inline void storeWord(uint8_t *out, uint32_t x)
+{
+    out[0] = (uint8_t)x;
+    out[1] = (uint8_t)(x >> 8);
+    out[2] = (uint8_t)(x >> 16);
+    out[3] = (uint8_t)(x >> 24);
+}
+
+// Loads one or two blocks into q.  A missing second block is zero.
+static void loadBlocks(uint32_t *q, const uint8_t *in, size_t count)
+{
+    for (uint8_t i = 0; i < 4; ++i) {
+        q[i * 2] = loadWord(in + i * 4);
+        q[i * 2 + 1] = (count > 1) ? loadWord(in + 16 + i * 4) : 0;
+    }
+    ortho(q);
+}
+
+static void storeBlocks(uint8_t *out, uint32_t *q, size_t count)
+{
+    ortho(q);
+    for (uint8_t i = 0; i < 4; ++i) {
+        storeWord(out + i * 4, q[i * 2]);
+        if (count > 1)
+            storeWord(out + 16 + i * 4, q[i * 2 + 1]);
+    }
+}
+
+static inline void addRoundKey(uint32_t *q, const uint32_t *sk)
+{
+    for (uint8_t i = 0; i < 8; ++i)
+        q[i] ^= sk[i];
+}
+
+static void shiftRows(uint32_t *q)
+{
+    for (uint8_t i = 0; i < 8; ++i) {
+        uint32_t x = q[i];
+        q[i] = (x & 0x000000FFU)
+             | ((x & 0x0000FC00U) >> 2) | ((x & 0x00000300U) << 6)
+             | ((x & 0x00F00000U) >> 4) | ((x & 0x000F0000U) << 4)
+             | ((x & 0xC0000000U) >> 6) | ((x & 0x3F000000U) << 2);
+    }
+}
+
+static void inverseShiftRows(uint32_t *q)
+{
+    for (uint8_t i = 0; i < 8; ++i) {
+        uint32_t x = q[i];
+        q[i] = (x & 0x000000FFU)
+             | ((x & 0x00003F00U) << 2) | ((x & 0x0000C000U) >> 6)
+             | ((x & 0x000F0000U) << 4) | ((x & 0x00F00000U) >> 4)
+             | ((x & 0x03000000U) << 6) | ((x & 0xFC000000U) >> 2);
+    }
+}
+
+static inline uint32_t rotr8(uint32_t x)
+{
+    return (x << 24) | (x >> 8);
+}
+
+static inline uint32_t rotr16(uint32_t x)
+{
+    return (x << 16) | (x >> 16);
+}
+
+static void mixColumns(uint32_t *q)
+{
+    uint32_t q0, q1, q2, q3, q4, q5, q6, q7;
+    uint32_t r0, r1, r2, r3, r4, r5, r6, r7;
+
+    q0 = q[0];
+    q1 = q[1];
+    q2 = q[2];
+    q3 = q[3];
+    q4 = q[4];
+    q5 = q[5];
+    q6 = q[6];
+    q7 = q[7];
+    r0 = rotr8(q0);
+    r1 = rotr8(q1);
+    r2 = rotr8(q2);
+    r3 = rotr8(q3);
+    r4 = rotr8(q4);
+    r5 = rotr8(q5);
+    r6 = rotr8(q6);
+    r7 = rotr8(q7);
+
+    q[0] = q7 ^ r7 ^ r0 ^ rotr16(q0 ^ r0);
+    q[1] = q0 ^ r0 ^ q7 ^ r7 ^ r1 ^ rotr16(q1 ^ r1);
+    q[2] = q1 ^ r1 ^ r2 ^ rotr16(q2 ^ r2);
+    q[3] = q2 ^ r2 ^ q7 ^ r7 ^ r3 ^ rotr16(q3 ^ r3);
+    q[4] = q3 ^ r3 ^ q7 ^ r7 ^ r4 ^ rotr16(q4 ^ r4);
+    q[5] = q4 ^ r4 ^ r5 ^ rotr16(q5 ^ r5);
+    q[6] = q5 ^ r5 ^ r6 ^ rotr16(q6 ^ r6);
+    q[7] = q6 ^ r6 ^ r7 ^ rotr16(q7 ^ r7);
+}
+
+// InvMixColumns multiplies each column by {0b,0d,09,0e}, which factors as
+// MixColumns applied after multiplying by {04,00,05,00}.  The second step
+// is a doubling twice and a rotation by two rows.
+static void inverseMixColumns(uint32_t *q)
+{
+    uint32_t u[8];
+    uint32_t carry;
+
+    for (uint8_t i = 0; i < 8; ++i)
+        u[i] = q[i] ^ rotr16(q[i]);
+    for (uint8_t n = 0; n < 2; ++n) {
+        carry = u[7];
+        u[7] = u[6];
+        u[6] = u[5];
+        u[5] = u[4];
+        u[4] = u[3] ^ carry;
+        u[3] = u[2] ^ carry;
+        u[2] = u[1];
+        u[1] = u[0] ^ carry;
+        u[0] = carry;
+    }
+    for (uint8_t i = 0; i < 8; ++i)
+        q[i] ^= u[i];
+    mixColumns(q);
+}
+
+static void bitsliceEncrypt(uint8_t rounds, const uint32_t *sk, uint32_t *q)
+{
+    addRoundKey(q, sk);
+    for (uint8_t round = 1; round < rounds; ++round) {
+        bitsliceSbox(q);
+        shiftRows(q);
+        mixColumns(q);
+        addRoundKey(q, sk + round * 8);
+    }
+    bitsliceSbox(q);
+    shiftRows(q);
+    addRoundKey(q, sk + rounds * 8);
+}
+
+static void bitsliceDecrypt(uint8_t rounds, const uint32_t *sk, uint32_t *q)
+{
+    addRoundKey(q, sk + rounds * 8);
+    for (uint8_t round = rounds - 1; round > 0; --round) {
+        inverseShiftRows(q);
+        bitsliceInverseSbox(q);
+        addRoundKey(q, sk + round * 8);
+        inverseMixColumns(q);
+    }
+    inverseShiftRows(q);
+    bitsliceInverseSbox(q);
+    addRoundKey(q, sk);
+}
+
+static uint32_t subWord(uint32_t x)
+{
+    uint32_t q[8];
+    memset(q, 0, sizeof(q));
+    q[0] = x;
+    ortho(q);
+    bitsliceSbox(q);
+    ortho(q);
+    x = q[0];
+    clean(q);
+    return x;
+}
+
+/** @endcond */
+
+/**
+ * \brief Constructs a bitsliced AES block cipher object.
+ */
+AESBitslicedCommon::AESBitslicedCommon()
+    : rounds(0), schedule(0)
+{
+}
+
+/**
+ * \brief Destroys this bitsliced AES block cipher object after clearing
+ * sensitive information.
+ */
+AESBitslicedCommon::~AESBitslicedCommon()
+{
+}
+
+/**
+ * \brief Size of an AES block in bytes.
+ * \return Always returns 16.
+ */
+size_t AESBitslicedCommon::blockSize() const
+{
+    return 16;
+}
+
+void AESBitslicedCommon::encryptBlock(uint8_t *output, const uint8_t *input)
+{
+    encryptBlocks(output, input, 1);
+}
+
+void AESBitslicedCommon::decryptBlock(uint8_t *output, const uint8_t *input)
+{
+    decryptBlocks(output, input, 1);
+}
+
+/**
+ * \brief Encrypts several consecutive blocks at once.
+ *
+ * \param output The output buffer to put the ciphertext into.
+ * \param input The input buffer to read the plaintext from.
+ * \param count The number of 16-byte blocks to encrypt.
+ *
+ * Blocks are processed two at a time, so an even \a count is the most
+ * efficient.  The \a input and \a output buffers may be the same.
+ *
+ * \sa decryptBlocks(), encryptBlock()
+ */
+bool AESBitslicedCommon::encryptBlocks(uint8_t *output, const uint8_t *input, size_t count)
+{
+    uint32_t q[8];
+    while (count > 0) {
+        loadBlocks(q, input, count);
+        bitsliceEncrypt(rounds, schedule, q);
+        storeBlocks(output, q, count);
+        if (count < 2)
+            break;
+        input += 32;
+        output += 32;
+        count -= 2;
+    }
+    clean(q);
+    return true;
+}
+
+/**
+ * \brief Decrypts several consecutive blocks at once.
+ *
+ * \param output The output buffer to put the plaintext into.
+ * \param input The input buffer to read the ciphertext from.
+ * \param count The number of 16-byte blocks to decrypt.
+ *
+ * \sa encryptBlocks(), decryptBlock()
+ */
+bool AESBitslicedCommon::decryptBlocks(uint8_t *output, const uint8_t *input, size_t count)
+{
+    uint32_t q[8];
+    while (count > 0) {
+        loadBlocks(q, input, count);
+        bitsliceDecrypt(rounds, schedule, q);
+        storeBlocks(output, q, count);
+        if (count < 2)
+            break;
+        input += 32;
+        output += 32;
+        count -= 2;
+    }
+    clean(q);
+    return true;
+}
+
+void AESBitslicedCommon::encryptBlockWithSlot(int slot, uint8_t *output, const uint8_t *input)
+{
+    ECCX08.aesEncryptECB(slot, input, output);
+}
+
+void AESBitslicedCommon::decryptBlockWithSlot(int slot, uint8_t *output, const uint8_t *input)
+{
+    ECCX08.aesDecryptECB(slot, input, output);
+}
+
+void AESBitslicedCommon::clear()
+{
+    clean(schedule, (rounds + 1) * 8 * sizeof(uint32_t));
+}
+
+/**
+ * \brief Expands \a key into the bitsliced key schedule.
+ *
+ * The schedule is computed in the ordinary word representation, with the
+ * S-box evaluated by the same circuit as the rounds, and then each round
+ * key is duplicated across both block positions and bitsliced.
+ */
+void AESBitslicedCommon::expandKey(const uint8_t *key, size_t len)
+{
+    static uint8_t const rcon[10] = {
+        0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1B, 0x36
+    };
+    uint8_t nk = len / 4;
+    uint8_t total = (rounds + 1) * 4;
+    uint8_t i, j, k;
+    uint32_t temp = 0;
+
+    for (i = 0; i < nk; ++i) {
+        temp = loadWord(key + i * 4);
+        schedule[i * 2] = temp;
+        schedule[i * 2 + 1] = temp;
+    }
+    for (i = nk, j = 0, k = 0; i < total; ++i) {
+        if (j == 0) {
+            temp = (temp << 24) | (temp >> 8);
+            temp = subWord(temp) ^ rcon[k];
+        } else if (nk > 6 && j == 4) {
+            temp = subWord(temp);
+        }
+        temp ^= schedule[(i - nk) * 2];
+        schedule[i * 2] = temp;
+        schedule[i * 2 + 1] = temp;
+        if (++j == nk) {
+            j = 0;
+            ++k;
+        }
+    }
+    for (i = 0; i < total; i += 4)
+        ortho(schedule + i * 2);
+    temp = 0;
+}
+
+/**
+ * \brief Constructs a bitsliced AES 128-bit block cipher with no
+ * initial key.
+ */
+AESBitsliced128::AESBitsliced128()
+{
+    rounds = 10;
+    schedule = sched;
+}
+
+AESBitsliced128::~AESBitsliced128()
+{
+    clean(sched);
+}
+
+/**
+ * \brief Size of a 128-bit AES key in bytes.
+ * \return Always returns 16.
+ */
+size_t AESBitsliced128::keySize() const
+{
+    return 16;
+}
+
+bool AESBitsliced128::setKey(const uint8_t *key, size_t len)
+{
+    if (len != 16)
+        return false;
+    expandKey(key, len);
+    return true;
+}
+
+/**
+ * \brief Constructs a bitsliced AES 256-bit block cipher with no
+ * initial key.
+ */
+AESBitsliced256::AESBitsliced256()
+{
+    rounds = 14;
+    schedule = sched;
+}
+
+AESBitsliced256::~AESBitsliced256()
+{
+    clean(sched);
+}
+
+/**
+ * \brief Size of a 256-bit AES key in bytes.
+ * \return Always returns 32.
+ */
+size_t AESBitsliced256::keySize() const
+{
+    return 32;
+}
+
+bool AESBitsliced256::setKey(const uint8_t *key, size_t len)
+{
+    if (len != 32)
+        return false;
+    expandKey(key, len);
+    return true;
+}
+
+#endif // CRYPTO_AES_DEFAULT
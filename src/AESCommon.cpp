@@ -24,6 +24,10 @@
 #include "Crypto.h"
 #include "utility/ProgMemUtil.h"
 #include "ArduinoECCX08.h"
+#if defined(CRYPTO_AES_AESNI)
+#include <cpuid.h>
+#include <wmmintrin.h>
+#endif
 
 #if defined(CRYPTO_AES_DEFAULT) || defined(CRYPTO_DOC)
 
@@ -41,6 +45,11 @@
  * and decryption operations.  Unless AES compatibility is required,
  * it is recommended that the ChaCha stream cipher be used instead.
  *
+ * A new object uses the key in slot 0 of the ECCX08 chip until setKey()
+ * or setKeySlot() is called.  After clear() there is no key at all:
+ * encryptBlock() and decryptBlock() zero their output and encryptBlocks()
+ * and decryptBlocks() return false until a new key is set.
+ *
  * Reference: http://en.wikipedia.org/wiki/Advanced_Encryption_Standard
  *
  * \sa ChaCha, AES128, AES192, AES256
@@ -122,11 +131,386 @@ static uint8_t const sbox_inverse[256] PROGMEM = {
 
 /** @endcond */
 
+#if defined(CRYPTO_AES_TTABLE)
+
+/** @cond aes_ttable */
+
+// Round tables for the word oriented implementation.  Te0[x] is the
+// MixColumns contribution of S(x) in row 0 of a column, as a little-endian
+// word.  The contributions from rows 1, 2 and 3 are the same word rotated
+// left by 8, 16 and 24 bits, so one 1K table covers all four.  Td0 does
+// the same for InvMixColumns and the inverse S-box.
+static uint32_t const Te0[256] PROGMEM = {
+    0xA56363C6, 0x847C7CF8, 0x997777EE, 0x8D7B7BF6,
+    0x0DF2F2FF, 0xBD6B6BD6, 0xB16F6FDE, 0x54C5C591,
+    0x50303060, 0x03010102, 0xA96767CE, 0x7D2B2B56,
+    0x19FEFEE7, 0x62D7D7B5, 0xE6ABAB4D, 0x9A7676EC,
+    0x45CACA8F, 0x9D82821F, 0x40C9C989, 0x877D7DFA,
+    0x15FAFAEF, 0xEB5959B2, 0xC947478E, 0x0BF0F0FB,
+    0xECADAD41, 0x67D4D4B3, 0xFDA2A25F, 0xEAAFAF45,
+    0xBF9C9C23, 0xF7A4A453, 0x967272E4, 0x5BC0C09B,
+    0xC2B7B775, 0x1CFDFDE1, 0xAE93933D, 0x6A26264C,
+    0x5A36366C, 0x413F3F7E, 0x02F7F7F5, 0x4FCCCC83,
+    0x5C343468, 0xF4A5A551, 0x34E5E5D1, 0x08F1F1F9,
+    0x937171E2, 0x73D8D8AB, 0x53313162, 0x3F15152A,
+    0x0C040408, 0x52C7C795, 0x65232346, 0x5EC3C39D,
+    0x28181830, 0xA1969637, 0x0F05050A, 0xB59A9A2F,
+    0x0907070E, 0x36121224, 0x9B80801B, 0x3DE2E2DF,
+    0x26EBEBCD, 0x6927274E, 0xCDB2B27F, 0x9F7575EA,
+    0x1B090912, 0x9E83831D, 0x742C2C58, 0x2E1A1A34,
+    0x2D1B1B36, 0xB26E6EDC, 0xEE5A5AB4, 0xFBA0A05B,
+    0xF65252A4, 0x4D3B3B76, 0x61D6D6B7, 0xCEB3B37D,
+    0x7B292952, 0x3EE3E3DD, 0x712F2F5E, 0x97848413,
+    0xF55353A6, 0x68D1D1B9, 0x00000000, 0x2CEDEDC1,
+    0x60202040, 0x1FFCFCE3, 0xC8B1B179, 0xED5B5BB6,
+    0xBE6A6AD4, 0x46CBCB8D, 0xD9BEBE67, 0x4B393972,
+    0xDE4A4A94, 0xD44C4C98, 0xE85858B0, 0x4ACFCF85,
+    0x6BD0D0BB, 0x2AEFEFC5, 0xE5AAAA4F, 0x16FBFBED,
+    0xC5434386, 0xD74D4D9A, 0x55333366, 0x94858511,
+    0xCF45458A, 0x10F9F9E9, 0x06020204, 0x817F7FFE,
+    0xF05050A0, 0x443C3C78, 0xBA9F9F25, 0xE3A8A84B,
+    0xF35151A2, 0xFEA3A35D, 0xC0404080, 0x8A8F8F05,
+    0xAD92923F, 0xBC9D9D21, 0x48383870, 0x04F5F5F1,
+    0xDFBCBC63, 0xC1B6B677, 0x75DADAAF, 0x63212142,
+    0x30101020, 0x1AFFFFE5, 0x0EF3F3FD, 0x6DD2D2BF,
+    0x4CCDCD81, 0x140C0C18, 0x35131326, 0x2FECECC3,
+    0xE15F5FBE, 0xA2979735, 0xCC444488, 0x3917172E,
+    0x57C4C493, 0xF2A7A755, 0x827E7EFC, 0x473D3D7A,
+    0xAC6464C8, 0xE75D5DBA, 0x2B191932, 0x957373E6,
+    0xA06060C0, 0x98818119, 0xD14F4F9E, 0x7FDCDCA3,
+    0x66222244, 0x7E2A2A54, 0xAB90903B, 0x8388880B,
+    0xCA46468C, 0x29EEEEC7, 0xD3B8B86B, 0x3C141428,
+    0x79DEDEA7, 0xE25E5EBC, 0x1D0B0B16, 0x76DBDBAD,
+    0x3BE0E0DB, 0x56323264, 0x4E3A3A74, 0x1E0A0A14,
+    0xDB494992, 0x0A06060C, 0x6C242448, 0xE45C5CB8,
+    0x5DC2C29F, 0x6ED3D3BD, 0xEFACAC43, 0xA66262C4,
+    0xA8919139, 0xA4959531, 0x37E4E4D3, 0x8B7979F2,
+    0x32E7E7D5, 0x43C8C88B, 0x5937376E, 0xB76D6DDA,
+    0x8C8D8D01, 0x64D5D5B1, 0xD24E4E9C, 0xE0A9A949,
+    0xB46C6CD8, 0xFA5656AC, 0x07F4F4F3, 0x25EAEACF,
+    0xAF6565CA, 0x8E7A7AF4, 0xE9AEAE47, 0x18080810,
+    0xD5BABA6F, 0x887878F0, 0x6F25254A, 0x722E2E5C,
+    0x241C1C38, 0xF1A6A657, 0xC7B4B473, 0x51C6C697,
+    0x23E8E8CB, 0x7CDDDDA1, 0x9C7474E8, 0x211F1F3E,
+    0xDD4B4B96, 0xDCBDBD61, 0x868B8B0D, 0x858A8A0F,
+    0x907070E0, 0x423E3E7C, 0xC4B5B571, 0xAA6666CC,
+    0xD8484890, 0x05030306, 0x01F6F6F7, 0x120E0E1C,
+    0xA36161C2, 0x5F35356A, 0xF95757AE, 0xD0B9B969,
+    0x91868617, 0x58C1C199, 0x271D1D3A, 0xB99E9E27,
+    0x38E1E1D9, 0x13F8F8EB, 0xB398982B, 0x33111122,
+    0xBB6969D2, 0x70D9D9A9, 0x898E8E07, 0xA7949433,
+    0xB69B9B2D, 0x221E1E3C, 0x92878715, 0x20E9E9C9,
+    0x49CECE87, 0xFF5555AA, 0x78282850, 0x7ADFDFA5,
+    0x8F8C8C03, 0xF8A1A159, 0x80898909, 0x170D0D1A,
+    0xDABFBF65, 0x31E6E6D7, 0xC6424284, 0xB86868D0,
+    0xC3414182, 0xB0999929, 0x772D2D5A, 0x110F0F1E,
+    0xCBB0B07B, 0xFC5454A8, 0xD6BBBB6D, 0x3A16162C
+};
+
+static uint32_t const Td0[256] PROGMEM = {
+    0x50A7F451, 0x5365417E, 0xC3A4171A, 0x965E273A,
+    0xCB6BAB3B, 0xF1459D1F, 0xAB58FAAC, 0x9303E34B,
+    0x55FA3020, 0xF66D76AD, 0x9176CC88, 0x254C02F5,
+    0xFCD7E54F, 0xD7CB2AC5, 0x80443526, 0x8FA362B5,
+    0x495AB1DE, 0x671BBA25, 0x980EEA45, 0xE1C0FE5D,
+    0x02752FC3, 0x12F04C81, 0xA397468D, 0xC6F9D36B,
+    0xE75F8F03, 0x959C9215, 0xEB7A6DBF, 0xDA595295,
+    0x2D83BED4, 0xD3217458, 0x2969E049, 0x44C8C98E,
+    0x6A89C275, 0x78798EF4, 0x6B3E5899, 0xDD71B927,
+    0xB64FE1BE, 0x17AD88F0, 0x66AC20C9, 0xB43ACE7D,
+    0x184ADF63, 0x82311AE5, 0x60335197, 0x457F5362,
+    0xE07764B1, 0x84AE6BBB, 0x1CA081FE, 0x942B08F9,
+    0x58684870, 0x19FD458F, 0x876CDE94, 0xB7F87B52,
+    0x23D373AB, 0xE2024B72, 0x578F1FE3, 0x2AAB5566,
+    0x0728EBB2, 0x03C2B52F, 0x9A7BC586, 0xA50837D3,
+    0xF2872830, 0xB2A5BF23, 0xBA6A0302, 0x5C8216ED,
+    0x2B1CCF8A, 0x92B479A7, 0xF0F207F3, 0xA1E2694E,
+    0xCDF4DA65, 0xD5BE0506, 0x1F6234D1, 0x8AFEA6C4,
+    0x9D532E34, 0xA055F3A2, 0x32E18A05, 0x75EBF6A4,
+    0x39EC830B, 0xAAEF6040, 0x069F715E, 0x51106EBD,
+    0xF98A213E, 0x3D06DD96, 0xAE053EDD, 0x46BDE64D,
+    0xB58D5491, 0x055DC471, 0x6FD40604, 0xFF155060,
+    0x24FB9819, 0x97E9BDD6, 0xCC434089, 0x779ED967,
+    0xBD42E8B0, 0x888B8907, 0x385B19E7, 0xDBEEC879,
+    0x470A7CA1, 0xE90F427C, 0xC91E84F8, 0x00000000,
+    0x83868009, 0x48ED2B32, 0xAC70111E, 0x4E725A6C,
+    0xFBFF0EFD, 0x5638850F, 0x1ED5AE3D, 0x27392D36,
+    0x64D90F0A, 0x21A65C68, 0xD1545B9B, 0x3A2E3624,
+    0xB1670A0C, 0x0FE75793, 0xD296EEB4, 0x9E919B1B,
+    0x4FC5C080, 0xA220DC61, 0x694B775A, 0x161A121C,
+    0x0ABA93E2, 0xE52AA0C0, 0x43E0223C, 0x1D171B12,
+    0x0B0D090E, 0xADC78BF2, 0xB9A8B62D, 0xC8A91E14,
+    0x8519F157, 0x4C0775AF, 0xBBDD99EE, 0xFD607FA3,
+    0x9F2601F7, 0xBCF5725C, 0xC53B6644, 0x347EFB5B,
+    0x7629438B, 0xDCC623CB, 0x68FCEDB6, 0x63F1E4B8,
+    0xCADC31D7, 0x10856342, 0x40229713, 0x2011C684,
+    0x7D244A85, 0xF83DBBD2, 0x1132F9AE, 0x6DA129C7,
+    0x4B2F9E1D, 0xF330B2DC, 0xEC52860D, 0xD0E3C177,
+    0x6C16B32B, 0x99B970A9, 0xFA489411, 0x2264E947,
+    0xC48CFCA8, 0x1A3FF0A0, 0xD82C7D56, 0xEF903322,
+    0xC74E4987, 0xC1D138D9, 0xFEA2CA8C, 0x360BD498,
+    0xCF81F5A6, 0x28DE7AA5, 0x268EB7DA, 0xA4BFAD3F,
+    0xE49D3A2C, 0x0D927850, 0x9BCC5F6A, 0x62467E54,
+    0xC2138DF6, 0xE8B8D890, 0x5EF7392E, 0xF5AFC382,
+    0xBE805D9F, 0x7C93D069, 0xA92DD56F, 0xB31225CF,
+    0x3B99ACC8, 0xA77D1810, 0x6E639CE8, 0x7BBB3BDB,
+    0x097826CD, 0xF418596E, 0x01B79AEC, 0xA89A4F83,
+    0x656E95E6, 0x7EE6FFAA, 0x08CFBC21, 0xE6E815EF,
+    0xD99BE7BA, 0xCE366F4A, 0xD4099FEA, 0xD67CB029,
+    0xAFB2A431, 0x31233F2A, 0x3094A5C6, 0xC066A235,
+    0x37BC4E74, 0xA6CA82FC, 0xB0D090E0, 0x15D8A733,
+    0x4A9804F1, 0xF7DAEC41, 0x0E50CD7F, 0x2FF69117,
+    0x8DD64D76, 0x4DB0EF43, 0x544DAACC, 0xDF0496E4,
+    0xE3B5D19E, 0x1B886A4C, 0xB81F2CC1, 0x7F516546,
+    0x04EA5E9D, 0x5D358C01, 0x737487FA, 0x2E410BFB,
+    0x5A1D67B3, 0x52D2DB92, 0x335610E9, 0x1347D66D,
+    0x8C61D79A, 0x7A0CA137, 0x8E14F859, 0x893C13EB,
+    0xEE27A9CE, 0x35C961B7, 0xEDE51CE1, 0x3CB1477A,
+    0x59DFD29C, 0x3F73F255, 0x79CE1418, 0xBF37C773,
+    0xEACDF753, 0x5BAAFD5F, 0x146F3DDF, 0x86DB4478,
+    0x81F3AFCA, 0x3EC468B9, 0x2C342438, 0x5F40A3C2,
+    0x72C31D16, 0x0C25E2BC, 0x8B493C28, 0x41950DFF,
+    0x7101A839, 0xDEB30C08, 0x9CE4B4D8, 0x90C15664,
+    0x6184CB7B, 0x70B632D5, 0x745C6C48, 0x4257B8D0
+};
+
+#define ROTL(x, n)  (((x) << (n)) | ((x) >> (32 - (n))))
+#define TE0(x)      (pgm_read_dword(Te0 + ((x) & 0xFF)))
+#define TE1(x)      ROTL(pgm_read_dword(Te0 + (((x) >> 8) & 0xFF)), 8)
+#define TE2(x)      ROTL(pgm_read_dword(Te0 + (((x) >> 16) & 0xFF)), 16)
+#define TE3(x)      ROTL(pgm_read_dword(Te0 + ((x) >> 24)), 24)
+#define TD0(x)      (pgm_read_dword(Td0 + ((x) & 0xFF)))
+#define TD1(x)      ROTL(pgm_read_dword(Td0 + (((x) >> 8) & 0xFF)), 8)
+#define TD2(x)      ROTL(pgm_read_dword(Td0 + (((x) >> 16) & 0xFF)), 16)
+#define TD3(x)      ROTL(pgm_read_dword(Td0 + ((x) >> 24)), 24)
+#define SB(x, n)    ((uint32_t)pgm_read_byte(sbox + (((x) >> (n * 8)) & 0xFF)) << (n * 8))
+#define ISB(x, n)   ((uint32_t)pgm_read_byte(sbox_inverse + (((x) >> (n * 8)) & 0xFF)) << (n * 8))
+
+static inline uint32_t loadWord(const uint8_t *p)
+{
+    return ((uint32_t)p[0]) | (((uint32_t)p[1]) << 8) |
+           (((uint32_t)p[2]) << 16) | (((uint32_t)p[3]) << 24);
+}
+
+static inline void storeWord(uint8_t *p, uint32_t x)
+{
+    p[0] = (uint8_t)x;
+    p[1] = (uint8_t)(x >> 8);
+    p[2] = (uint8_t)(x >> 16);
+    p[3] = (uint8_t)(x >> 24);
+}
+
+// InvMixColumns applied to a round key word, which turns the normal key
+// schedule into the one for the equivalent inverse cipher on the fly.
+static inline uint32_t inverseMixWord(uint32_t x)
+{
+    x = SB(x, 0) | SB(x, 1) | SB(x, 2) | SB(x, 3);
+    return TD0(x) ^ TD1(x) ^ TD2(x) ^ TD3(x);
+}
+
+static void encryptTTable(const uint8_t *roundKey, uint8_t rounds,
+                          uint8_t *output, const uint8_t *input)
+{
+    uint32_t s0, s1, s2, s3;
+    uint32_t t0, t1, t2, t3;
+
+    // Load the state as four little-endian column words and add the
+    // first round key.
+    s0 = loadWord(input)      ^ loadWord(roundKey);
+    s1 = loadWord(input + 4)  ^ loadWord(roundKey + 4);
+    s2 = loadWord(input + 8)  ^ loadWord(roundKey + 8);
+    s3 = loadWord(input + 12) ^ loadWord(roundKey + 12);
+    roundKey += 16;
+
+    // SubBytes, ShiftRows and MixColumns are a table lookup per byte.
+    for (uint8_t round = rounds; round > 1; --round) {
+        t0 = TE0(s0) ^ TE1(s1) ^ TE2(s2) ^ TE3(s3) ^ loadWord(roundKey);
+        t1 = TE0(s1) ^ TE1(s2) ^ TE2(s3) ^ TE3(s0) ^ loadWord(roundKey + 4);
+        t2 = TE0(s2) ^ TE1(s3) ^ TE2(s0) ^ TE3(s1) ^ loadWord(roundKey + 8);
+        t3 = TE0(s3) ^ TE1(s0) ^ TE2(s1) ^ TE3(s2) ^ loadWord(roundKey + 12);
+        s0 = t0;
+        s1 = t1;
+        s2 = t2;
+        s3 = t3;
+        roundKey += 16;
+    }
+
+    // The final round has no MixColumns.
+    storeWord(output,      (SB(s0, 0) | SB(s1, 1) | SB(s2, 2) | SB(s3, 3)) ^ loadWord(roundKey));
+    storeWord(output + 4,  (SB(s1, 0) | SB(s2, 1) | SB(s3, 2) | SB(s0, 3)) ^ loadWord(roundKey + 4));
+    storeWord(output + 8,  (SB(s2, 0) | SB(s3, 1) | SB(s0, 2) | SB(s1, 3)) ^ loadWord(roundKey + 8));
+    storeWord(output + 12, (SB(s3, 0) | SB(s0, 1) | SB(s1, 2) | SB(s2, 3)) ^ loadWord(roundKey + 12));
+}
+
+static void decryptTTable(const uint8_t *schedule, uint8_t rounds,
+                          uint8_t *output, const uint8_t *input)
+{
+    const uint8_t *roundKey = schedule + rounds * 16;
+    uint32_t s0, s1, s2, s3;
+    uint32_t t0, t1, t2, t3;
+
+    s0 = loadWord(input)      ^ loadWord(roundKey);
+    s1 = loadWord(input + 4)  ^ loadWord(roundKey + 4);
+    s2 = loadWord(input + 8)  ^ loadWord(roundKey + 8);
+    s3 = loadWord(input + 12) ^ loadWord(roundKey + 12);
+
+    for (uint8_t round = rounds; round > 1; --round) {
+        roundKey -= 16;
+        t0 = TD0(s0) ^ TD1(s3) ^ TD2(s2) ^ TD3(s1) ^ inverseMixWord(loadWord(roundKey));
+        t1 = TD0(s1) ^ TD1(s0) ^ TD2(s3) ^ TD3(s2) ^ inverseMixWord(loadWord(roundKey + 4));
+        t2 = TD0(s2) ^ TD1(s1) ^ TD2(s0) ^ TD3(s3) ^ inverseMixWord(loadWord(roundKey + 8));
+        t3 = TD0(s3) ^ TD1(s2) ^ TD2(s1) ^ TD3(s0) ^ inverseMixWord(loadWord(roundKey + 12));
+        s0 = t0;
+        s1 = t1;
+        s2 = t2;
+        s3 = t3;
+    }
+
+    roundKey -= 16;
+    storeWord(output,      (ISB(s0, 0) | ISB(s3, 1) | ISB(s2, 2) | ISB(s1, 3)) ^ loadWord(roundKey));
+    storeWord(output + 4,  (ISB(s1, 0) | ISB(s0, 1) | ISB(s3, 2) | ISB(s2, 3)) ^ loadWord(roundKey + 4));
+    storeWord(output + 8,  (ISB(s2, 0) | ISB(s1, 1) | ISB(s0, 2) | ISB(s3, 3)) ^ loadWord(roundKey + 8));
+    storeWord(output + 12, (ISB(s3, 0) | ISB(s2, 1) | ISB(s1, 2) | ISB(s0, 3)) ^ loadWord(roundKey + 12));
+}
+
+/** @endcond */
+
+#endif // CRYPTO_AES_TTABLE
+
+#if defined(CRYPTO_AES_AESNI)
+
+/** @cond aes_aesni */
+
+static bool hasAESNI()
+{
+    static int8_t supported = -1;
+    if (supported < 0) {
+        unsigned int eax, ebx, ecx, edx;
+        if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_AES))
+            supported = 1;
+        else
+            supported = 0;
+    }
+    return supported != 0;
+}
+
+// The schedule is already in the byte order that AESENC expects.
+__attribute__((target("aes,sse2")))
+static void encryptAESNI(const uint8_t *schedule, uint8_t rounds,
+                         uint8_t *output, const uint8_t *input)
+{
+    const __m128i *roundKey = (const __m128i *)schedule;
+    __m128i s = _mm_loadu_si128((const __m128i *)input);
+
+    s = _mm_xor_si128(s, _mm_loadu_si128(roundKey));
+    for (uint8_t round = 1; round < rounds; ++round)
+        s = _mm_aesenc_si128(s, _mm_loadu_si128(roundKey + round));
+    s = _mm_aesenclast_si128(s, _mm_loadu_si128(roundKey + rounds));
+    _mm_storeu_si128((__m128i *)output, s);
+}
+
+// AESDEC implements the equivalent inverse cipher, so the middle round
+// keys go through InvMixColumns (AESIMC) first.  They don't depend on the
+// state, which lets the CPU overlap them with the rounds.
+__attribute__((target("aes,sse2")))
+static void decryptAESNI(const uint8_t *schedule, uint8_t rounds,
+                         uint8_t *output, const uint8_t *input)
+{
+    const __m128i *roundKey = (const __m128i *)schedule;
+    __m128i s = _mm_loadu_si128((const __m128i *)input);
+
+    s = _mm_xor_si128(s, _mm_loadu_si128(roundKey + rounds));
+    for (uint8_t round = rounds - 1; round > 0; --round)
+        s = _mm_aesdec_si128(s, _mm_aesimc_si128(_mm_loadu_si128(roundKey + round)));
+    s = _mm_aesdeclast_si128(s, _mm_loadu_si128(roundKey));
+    _mm_storeu_si128((__m128i *)output, s);
+}
+
+// Four blocks go through each round together, which hides the latency of
+// AESENC/AESDEC behind the other three.
+__attribute__((target("aes,sse2")))
+static void encryptBlocksAESNI(const uint8_t *schedule, uint8_t rounds,
+                               uint8_t *output, const uint8_t *input,
+                               size_t count)
+{
+    const __m128i *roundKey = (const __m128i *)schedule;
+    __m128i k, s0, s1, s2, s3;
+
+    for (; count >= 4; count -= 4, input += 64, output += 64) {
+        k = _mm_loadu_si128(roundKey);
+        s0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)input), k);
+        s1 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(input + 16)), k);
+        s2 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(input + 32)), k);
+        s3 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(input + 48)), k);
+        for (uint8_t round = 1; round < rounds; ++round) {
+            k = _mm_loadu_si128(roundKey + round);
+            s0 = _mm_aesenc_si128(s0, k);
+            s1 = _mm_aesenc_si128(s1, k);
+            s2 = _mm_aesenc_si128(s2, k);
+            s3 = _mm_aesenc_si128(s3, k);
+        }
+        k = _mm_loadu_si128(roundKey + rounds);
+        _mm_storeu_si128((__m128i *)output, _mm_aesenclast_si128(s0, k));
+        _mm_storeu_si128((__m128i *)(output + 16), _mm_aesenclast_si128(s1, k));
+        _mm_storeu_si128((__m128i *)(output + 32), _mm_aesenclast_si128(s2, k));
+        _mm_storeu_si128((__m128i *)(output + 48), _mm_aesenclast_si128(s3, k));
+    }
+    for (; count > 0; --count, input += 16, output += 16)
+        encryptAESNI(schedule, rounds, output, input);
+}
+
+__attribute__((target("aes,sse2")))
+static void decryptBlocksAESNI(const uint8_t *schedule, uint8_t rounds,
+                               uint8_t *output, const uint8_t *input,
+                               size_t count)
+{
+    const __m128i *roundKey = (const __m128i *)schedule;
+    __m128i inverse[15];
+    __m128i k, s0, s1, s2, s3;
+
+    // Convert the middle round keys once for the whole run.
+    inverse[0] = _mm_loadu_si128(roundKey);
+    for (uint8_t round = 1; round < rounds; ++round)
+        inverse[round] = _mm_aesimc_si128(_mm_loadu_si128(roundKey + round));
+    inverse[rounds] = _mm_loadu_si128(roundKey + rounds);
+
+    for (; count >= 4; count -= 4, input += 64, output += 64) {
+        k = inverse[rounds];
+        s0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)input), k);
+        s1 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(input + 16)), k);
+        s2 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(input + 32)), k);
+        s3 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(input + 48)), k);
+        for (uint8_t round = rounds - 1; round > 0; --round) {
+            k = inverse[round];
+            s0 = _mm_aesdec_si128(s0, k);
+            s1 = _mm_aesdec_si128(s1, k);
+            s2 = _mm_aesdec_si128(s2, k);
+            s3 = _mm_aesdec_si128(s3, k);
+        }
+        k = inverse[0];
+        _mm_storeu_si128((__m128i *)output, _mm_aesdeclast_si128(s0, k));
+        _mm_storeu_si128((__m128i *)(output + 16), _mm_aesdeclast_si128(s1, k));
+        _mm_storeu_si128((__m128i *)(output + 32), _mm_aesdeclast_si128(s2, k));
+        _mm_storeu_si128((__m128i *)(output + 48), _mm_aesdeclast_si128(s3, k));
+    }
+    for (; count > 0; --count, input += 16, output += 16) {
+        s0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)input), inverse[rounds]);
+        for (uint8_t round = rounds - 1; round > 0; --round)
+            s0 = _mm_aesdec_si128(s0, inverse[round]);
+        _mm_storeu_si128((__m128i *)output, _mm_aesdeclast_si128(s0, inverse[0]));
+    }
+    clean(inverse, sizeof(inverse));
+}
+
+/** @endcond */
+
+#endif // CRYPTO_AES_AESNI
+
 /**
  * \brief Constructs an AES block cipher object.
  */
 AESCommon::AESCommon()
-    : rounds(0), schedule(0)
+    : rounds(0), slot(0), keyed(false), schedule(0)
 {
 }
 
@@ -268,14 +652,169 @@ void AESCommon::inverseMixColumn(uint8_t *output, const uint8_t *input)
 
 /** @endcond */
 
+/**
+ * \brief Selects a key that lives in a slot of the ECCX08 chip.
+ *
+ * \param slot The slot number, or -1 to go back to the key that was last
+ * passed to setKey().
+ *
+ * Until setKey() is called, encryptBlock() and decryptBlock() use the key
+ * in slot 0 of the chip.  setKey() switches them to the software key
+ * schedule, which is far faster than a round trip to the chip.  Going back
+ * to -1 when setKey() was never called, or after clear(), leaves the
+ * cipher with no key.
+ *
+ * \sa setKey(), encryptBlockWithSlot()
+ */
+void AESCommon::setKeySlot(int slot)
+{
+    this->slot = slot;
+}
+
 void AESCommon::encryptBlock(uint8_t *output, const uint8_t *input)
 {
-    ECCX08.aesEncryptECB(0, input, output);
+    if (slot >= 0) {
+        ECCX08.aesEncryptECB(slot, input, output);
+        return;
+    }
+    if (!keyed) {
+        clean(output, 16);
+        return;
+    }
+
+#if defined(CRYPTO_AES_AESNI)
+    if (hasAESNI()) {
+        encryptAESNI(schedule, rounds, output, input);
+        return;
+    }
+#endif
+#if defined(CRYPTO_AES_TTABLE)
+    encryptTTable(schedule, rounds, output, input);
+#else
+    const uint8_t *roundKey = schedule;
+    uint8_t posn;
+    uint8_t round;
+    uint8_t state1[16];
+    uint8_t state2[16];
+
+    // Copy the input into the state and XOR with the first round key.
+    for (posn = 0; posn < 16; ++posn)
+        state1[posn] = input[posn] ^ roundKey[posn];
+    roundKey += 16;
+
+    // Perform all rounds except the last.
+    for (round = rounds; round > 1; --round) {
+        subBytesAndShiftRows(state2, state1);
+        mixColumn(state1,      state2);
+        mixColumn(state1 + 4,  state2 + 4);
+        mixColumn(state1 + 8,  state2 + 8);
+        mixColumn(state1 + 12, state2 + 12);
+        for (posn = 0; posn < 16; ++posn)
+            state1[posn] ^= roundKey[posn];
+        roundKey += 16;
+    }
+
+    // Perform the final round.
+    subBytesAndShiftRows(state2, state1);
+    for (posn = 0; posn < 16; ++posn)
+        output[posn] = state2[posn] ^ roundKey[posn];
+
+    // Clean up.
+    clean(state1);
+    clean(state2);
+#endif
 }
 
 void AESCommon::decryptBlock(uint8_t *output, const uint8_t *input)
 {
-    ECCX08.aesDecryptECB(0, input, output);
+    if (slot >= 0) {
+        ECCX08.aesDecryptECB(slot, input, output);
+        return;
+    }
+    if (!keyed) {
+        clean(output, 16);
+        return;
+    }
+
+#if defined(CRYPTO_AES_AESNI)
+    if (hasAESNI()) {
+        decryptAESNI(schedule, rounds, output, input);
+        return;
+    }
+#endif
+#if defined(CRYPTO_AES_TTABLE)
+    decryptTTable(schedule, rounds, output, input);
+#else
+    const uint8_t *roundKey = schedule + rounds * 16;
+    uint8_t round;
+    uint8_t posn;
+    uint8_t state1[16];
+    uint8_t state2[16];
+
+    // Copy the input into the state and reverse the final round.
+    for (posn = 0; posn < 16; ++posn)
+        state1[posn] = input[posn] ^ roundKey[posn];
+    inverseShiftRowsAndSubBytes(state2, state1);
+
+    // Perform all other rounds in reverse.
+    for (round = rounds; round > 1; --round) {
+        roundKey -= 16;
+        for (posn = 0; posn < 16; ++posn)
+            state2[posn] ^= roundKey[posn];
+        inverseMixColumn(state1,      state2);
+        inverseMixColumn(state1 + 4,  state2 + 4);
+        inverseMixColumn(state1 + 8,  state2 + 8);
+        inverseMixColumn(state1 + 12, state2 + 12);
+        inverseShiftRowsAndSubBytes(state2, state1);
+    }
+
+    // Reverse the initial round and create the output words.
+    roundKey -= 16;
+    for (posn = 0; posn < 16; ++posn)
+        output[posn] = state2[posn] ^ roundKey[posn];
+
+    // Clean up.
+    clean(state1);
+    clean(state2);
+#endif
+}
+
+bool AESCommon::encryptBlocks(uint8_t *output, const uint8_t *input, size_t count)
+{
+    if (slot >= 0)
+        return encryptBlocksWithSlot(slot, output, input, count);
+    if (!keyed) {
+        clean(output, count * 16);
+        return false;
+    }
+#if defined(CRYPTO_AES_AESNI)
+    if (hasAESNI()) {
+        encryptBlocksAESNI(schedule, rounds, output, input, count);
+        return true;
+    }
+#endif
+    for (; count > 0; --count, input += 16, output += 16)
+        AESCommon::encryptBlock(output, input);
+    return true;
+}
+
+bool AESCommon::decryptBlocks(uint8_t *output, const uint8_t *input, size_t count)
+{
+    if (slot >= 0)
+        return decryptBlocksWithSlot(slot, output, input, count);
+    if (!keyed) {
+        clean(output, count * 16);
+        return false;
+    }
+#if defined(CRYPTO_AES_AESNI)
+    if (hasAESNI()) {
+        decryptBlocksAESNI(schedule, rounds, output, input, count);
+        return true;
+    }
+#endif
+    for (; count > 0; --count, input += 16, output += 16)
+        AESCommon::decryptBlock(output, input);
+    return true;
 }
 
 void AESCommon::encryptBlockWithSlot(int slot, uint8_t *output, const uint8_t *input)
@@ -291,6 +830,8 @@ void AESCommon::decryptBlockWithSlot(int slot, uint8_t *output, const uint8_t *i
 void AESCommon::clear()
 {
     clean(schedule, (rounds + 1) * 16);
+    slot = -1;
+    keyed = false;
 }
 
 /** @cond aes_keycore */
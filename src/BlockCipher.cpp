@@ -21,6 +21,8 @@
  */
 
 #include "BlockCipher.h"
+#include "Crypto.h"
+#include "ECCX08.h"
 
 /**
  * \class BlockCipher BlockCipher.h <BlockCipher.h>
@@ -112,6 +114,116 @@ BlockCipher::~BlockCipher()
  * \sa encryptBlock(), blockSize()
  */
 
+/**
+ * \brief Encrypts several consecutive blocks using this cipher.
+ *
+ * \param output The output buffer to put the ciphertext into.
+ * Must be at least \a count * blockSize() bytes in length.
+ * \param input The input buffer to read the plaintext from which is
+ * allowed to be the same as \a output.  Must be at least
+ * \a count * blockSize() bytes in length.
+ * \param count The number of blocks to encrypt.
+ * \return Returns false if the blocks could not be encrypted, which only
+ * happens when the key is in a slot of the chip and the chip failed, or
+ * when the cipher has no key since clear().  \a output is zeroed in that
+ * case.
+ *
+ * The default implementation calls encryptBlock() once per block.
+ * Subclasses override it when they can process several blocks faster
+ * than one at a time, so modes such as CTR and GCM should hand over as
+ * many blocks as they have ready.
+ *
+ * \sa decryptBlocks(), encryptBlock()
+ */
+bool BlockCipher::encryptBlocks(uint8_t *output, const uint8_t *input, size_t count)
+{
+    size_t size = blockSize();
+    while (count > 0) {
+        encryptBlock(output, input);
+        output += size;
+        input += size;
+        --count;
+    }
+    return true;
+}
+
+/**
+ * \brief Decrypts several consecutive blocks using this cipher.
+ *
+ * \param output The output buffer to put the plaintext into.
+ * Must be at least \a count * blockSize() bytes in length.
+ * \param input The input buffer to read the ciphertext from which is
+ * allowed to be the same as \a output.  Must be at least
+ * \a count * blockSize() bytes in length.
+ * \param count The number of blocks to decrypt.
+ * \return Returns false if the blocks could not be decrypted, which only
+ * happens when the key is in a slot of the chip and the chip failed, or
+ * when the cipher has no key since clear().  \a output is zeroed in that
+ * case.
+ *
+ * The default implementation calls decryptBlock() once per block.
+ *
+ * \sa encryptBlocks(), decryptBlock()
+ */
+bool BlockCipher::decryptBlocks(uint8_t *output, const uint8_t *input, size_t count)
+{
+    size_t size = blockSize();
+    while (count > 0) {
+        decryptBlock(output, input);
+        output += size;
+        input += size;
+        --count;
+    }
+    return true;
+}
+
+/**
+ * \brief Encrypts several consecutive blocks with a key in a slot of the
+ * ATECC608.
+ *
+ * \param slot The slot that holds the key.
+ * \param output The output buffer to put the ciphertext into.
+ * \param input The input buffer to read the plaintext from, which is
+ * allowed to be the same as \a output.
+ * \param count The number of 16 byte blocks to encrypt.
+ * \return Returns false if the chip failed, in which case \a output
+ * is zeroed.
+ *
+ * Unlike calling encryptBlockWithSlot() once per block, the chip is woken
+ * up once for the whole batch.
+ *
+ * \sa decryptBlocksWithSlot(), encryptBlockWithSlot()
+ */
+bool BlockCipher::encryptBlocksWithSlot(int slot, uint8_t *output, const uint8_t *input, size_t count)
+{
+    if (ECCX08.aesEncryptECB(slot, input, output, count) == 1)
+        return true;
+    clean(output, count * 16);
+    return false;
+}
+
+/**
+ * \brief Decrypts several consecutive blocks with a key in a slot of the
+ * ATECC608.
+ *
+ * \param slot The slot that holds the key.
+ * \param output The output buffer to put the plaintext into.
+ * \param input The input buffer to read the ciphertext from, which is
+ * allowed to be the same as \a output.
+ * \param count The number of 16 byte blocks to decrypt.
+ * \return Returns false if the chip failed, in which case \a output
+ * is zeroed.
+ *
+ * \sa encryptBlocksWithSlot(), decryptBlockWithSlot()
+ */
+bool BlockCipher::decryptBlocksWithSlot(int slot, uint8_t *output, const uint8_t *input, size_t count)
+{
+    if (ECCX08.aesDecryptECB(slot, input, output, count) == 1)
+        return true;
+    clean(output, count * 16);
+    return false;
+}
+
 /**
  * \fn void BlockCipher::clear()
  * \brief Clears all security-sensitive state from this block cipher.
@@ -40,9 +40,15 @@ public:
     virtual void encryptBlock(uint8_t *output, const uint8_t *input) = 0;
     virtual void decryptBlock(uint8_t *output, const uint8_t *input) = 0;
 
+    virtual bool encryptBlocks(uint8_t *output, const uint8_t *input, size_t count);
+    virtual bool decryptBlocks(uint8_t *output, const uint8_t *input, size_t count);
+
     virtual void encryptBlockWithSlot(int slot, uint8_t *output, const uint8_t *input) = 0;
     virtual void decryptBlockWithSlot(int slot, uint8_t *output, const uint8_t *input) = 0;
 
+    virtual bool encryptBlocksWithSlot(int slot, uint8_t *output, const uint8_t *input, size_t count);
+    virtual bool decryptBlocksWithSlot(int slot, uint8_t *output, const uint8_t *input, size_t count);
+
     virtual void clear() = 0;
 };
 
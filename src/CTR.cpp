@@ -0,0 +1,347 @@
+/*
+ * Copyright (C) 2026 Operator Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "CTR.h"
+#include "Crypto.h"
+#include "ECCX08.h"
+#include <string.h>
+
+/**
+ * \class CTRCommon CTR.h <CTR.h>
+ * \brief Implementation of the Counter (CTR) mode for 128-bit block ciphers.
+ *
+ * Counter mode turns a block cipher into a stream cipher by encrypting
+ * successive counter values and XOR'ing the result with the data.  The
+ * block cipher can be keyed in software with setKey() or use a key in a
+ * slot of the ATECC608 with setKeySlot().
+ *
+ * Keystream is generated a few blocks at a time into a ring buffer of
+ * CRYPTO_CTR_BUFFER_SIZE bytes.  Calling precompute() while the
+ * application is otherwise idle fills the buffer ahead of time, so that
+ * encrypting the next packet of up to that size is a plain XOR with no
+ * block cipher or chip work at all.  Keystream that was computed but not
+ * used is discarded by setIV(), setKey() and setKeySlot().  setKey() and
+ * setKeySlot() also wind the counter back over the blocks that were not
+ * started, so the stream carries on under the new key exactly as it would
+ * have without precompute().
+ *
+ * Encryption and decryption are the same operation.  Never reuse a
+ * key and counter combination for two different messages.
+ *
+ * Reference: http://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
+ *
+ * \sa CTR, GCM
+ */
+
+/**
+ * \brief Constructs a new CTR object for a 128-bit block cipher.
+ *
+ * This constructor must be followed by a call to setBlockCipher().
+ */
+CTRCommon::CTRCommon()
+    : blockCipher(0)
+    , posn(0)
+    , avail(0)
+    , counterStart(0)
+    , slot(-1)
+{
+}
+
+/**
+ * \brief Destroys this CTR object after clearing sensitive information.
+ */
+CTRCommon::~CTRCommon()
+{
+    clean(counter);
+    clean(buffer);
+}
+
+size_t CTRCommon::keySize() const
+{
+    return blockCipher->keySize();
+}
+
+size_t CTRCommon::ivSize() const
+{
+    return 16;
+}
+
+/**
+ * \brief Sets the counter size for the IV.
+ *
+ * \param size The number of bytes on the end of the counter block that
+ * are relevant when incrementing, between 1 and 16.
+ * \return Returns false if the \a size value is not between 1 and 16.
+ *
+ * When the counter is incremented during encrypt(), only the last
+ * \a size bytes are considered relevant.  This can be useful to improve
+ * performance when the higher level protocol specifies that only the
+ * least significant N bytes "count".  The high level protocol should
+ * explicitly generate a new initial counter value and key long before
+ * the \a size bytes overflow and wrap around.
+ *
+ * By default, the counter size is 16 which is the same as the block size
+ * of the underlying block cipher.
+ *
+ * \sa setIV()
+ */
+bool CTRCommon::setCounterSize(size_t size)
+{
+    if (size < 1 || size > 16)
+        return false;
+    counterStart = 16 - size;
+    return true;
+}
+
+bool CTRCommon::setKey(const uint8_t *key, size_t len)
+{
+    // Verify the cipher's block size, just in case.
+    if (blockCipher->blockSize() != 16)
+        return false;
+
+    // Set the key on the underlying block cipher.
+    slot = -1;
+    discard();
+    return blockCipher->setKey(key, len);
+}
+
+/**
+ * \brief Selects a key in a slot of the ATECC608 instead of a software key.
+ *
+ * \param slot The slot number, or -1 to go back to the key that was last
+ * given to setKey().
+ *
+ * Each keystream block then costs one AES command on the chip, which is
+ * where precompute() pays off the most.  setKey() switches back to the
+ * software key.
+ *
+ * Any precomputed keystream is discarded and the counter goes back to the
+ * first block that was not started, as with setKey().
+ */
+void CTRCommon::setKeySlot(int slot)
+{
+    this->slot = slot;
+    discard();
+}
+
+/**
+ * \brief Sets the initial counter value to use for future encryption and
+ * decryption operations.
+ *
+ * \param iv The initial counter value which must contain exactly 16 bytes.
+ * \param len The length of the counter value, which must be 16.
+ * \return Returns false if \a len is not exactly 16.
+ *
+ * The precise method to generate the initial counter is not defined by
+ * this class.  Usually higher level protocols like SSL/TLS and SSH
+ * specify how to construct the initial counter value.  This class merely
+ * increments the counter every time a new block of keystream data is
+ * needed.
+ *
+ * \sa encrypt(), setCounterSize()
+ */
+bool CTRCommon::setIV(const uint8_t *iv, size_t len)
+{
+    if (len != 16)
+        return false;
+    memcpy(counter, iv, len);
+    posn = 0;
+    avail = 0;
+    return true;
+}
+
+void CTRCommon::encrypt(uint8_t *output, const uint8_t *input, size_t len)
+{
+    while (len > 0) {
+        // Generate more keystream if we have run out.  A failed chip
+        // gives none, so zero the rest rather than pass it through.
+        if (avail == 0 && precompute(len) == 0) {
+            clean(output, len);
+            return;
+        }
+
+        // XOR as much as we can without wrapping around the buffer.
+        size_t size = CRYPTO_CTR_BUFFER_SIZE - posn;
+        if (size > avail)
+            size = avail;
+        if (size > len)
+            size = len;
+        const uint8_t *stream = buffer + posn;
+        for (size_t i = 0; i < size; ++i)
+            output[i] = input[i] ^ stream[i];
+        posn = (posn + size) % CRYPTO_CTR_BUFFER_SIZE;
+        avail -= size;
+        output += size;
+        input += size;
+        len -= size;
+    }
+}
+
+void CTRCommon::decrypt(uint8_t *output, const uint8_t *input, size_t len)
+{
+    encrypt(output, input, len);
+}
+
+/**
+ * \brief Generates keystream ahead of time.
+ *
+ * \param len The number of bytes of keystream that the caller would like
+ * to have ready, which is capped at CRYPTO_CTR_BUFFER_SIZE.
+ * \return Returns the number of bytes of keystream that are now ready.
+ *
+ * Keystream is generated in whole blocks, so up to 15 bytes more than
+ * \a len may be produced.  If the buffer is full or holds a part-used
+ * block that stops another block from fitting, this does nothing.
+ *
+ * With a key slot, all of the blocks are encrypted in one wake of the
+ * chip.  If the chip fails, whether through setKeySlot() here or a block
+ * cipher that keeps its own key in a slot, the blocks are not added and
+ * the counter is left where it was, so the return value is what was
+ * available before.
+ *
+ * The key and IV must already be set.
+ *
+ * \sa available()
+ */
+size_t CTRCommon::precompute(size_t len)
+{
+    if (len > CRYPTO_CTR_BUFFER_SIZE)
+        len = CRYPTO_CTR_BUFFER_SIZE;
+    if (slot >= 0)
+        ECCX08.beginSession();
+    while (avail < len && (CRYPTO_CTR_BUFFER_SIZE - avail) >= 16) {
+        // The write position always falls on a block boundary, so
+        // fill in the blocks up to the end of the buffer or the
+        // unused keystream, whichever comes first.
+        size_t start = (posn + avail) % CRYPTO_CTR_BUFFER_SIZE;
+        size_t size = CRYPTO_CTR_BUFFER_SIZE - start;
+        size_t space = (CRYPTO_CTR_BUFFER_SIZE - avail) & ~((size_t)15);
+        size_t wanted = (len - avail + 15) & ~((size_t)15);
+        if (size > space)
+            size = space;
+        if (size > wanted)
+            size = wanted;
+
+        // Encrypt the counter blocks, several at once if we can.
+        uint8_t *stream = buffer + start;
+        for (size_t i = 0; i < size; i += 16) {
+            memcpy(stream + i, counter, 16);
+            increment();
+        }
+        bool ok;
+        if (slot < 0)
+            ok = blockCipher->encryptBlocks(stream, stream, size / 16);
+        else
+            ok = blockCipher->encryptBlocksWithSlot(slot, stream, stream, size / 16);
+        if (!ok) {
+            rewind(size / 16);
+            break;
+        }
+        avail += size;
+    }
+    if (slot >= 0)
+        ECCX08.endSession();
+    return avail;
+}
+
+void CTRCommon::clear()
+{
+    blockCipher->clear();
+    clean(counter);
+    clean(buffer);
+    posn = 0;
+    avail = 0;
+    slot = -1;
+}
+
+/**
+ * \brief Drops the precomputed keystream and winds the counter back over
+ * the blocks that were not started.
+ *
+ * A part-used block at the read position is not counted, because its
+ * counter value has already been used under the old key.
+ */
+void CTRCommon::discard()
+{
+    rewind(avail / 16);
+    posn = 0;
+    avail = 0;
+}
+
+/**
+ * \brief Decrements the counter by \a blocks, ignoring bytes before
+ * counterStart.
+ */
+void CTRCommon::rewind(size_t blocks)
+{
+    while (blocks > 0) {
+        uint8_t i = 16;
+        while (i > counterStart) {
+            --i;
+            if (counter[i]-- != 0)
+                break;
+        }
+        --blocks;
+    }
+}
+
+/**
+ * \brief Increments the counter, ignoring bytes before counterStart.
+ */
+void CTRCommon::increment()
+{
+    uint16_t carry = 1;
+    uint8_t i = 16;
+    while (i > counterStart) {
+        --i;
+        carry += counter[i];
+        counter[i] = (uint8_t)carry;
+        carry >>= 8;
+    }
+}
+
+/**
+ * \class CTR CTR.h <CTR.h>
+ * \brief Implementation of the Counter (CTR) mode for 128-bit block ciphers.
+ *
+ * The template parameter T must be a concrete subclass of BlockCipher
+ * indicating the specific block cipher to use.  T must have a block size
+ * of 16 bytes (128 bits).
+ *
+ * For example, the following creates a CTR object using AES256 as the
+ * underlying cipher:
+ *
+ * \code
+ * CTR<AES256> ctr;
+ * ctr.setKey(key, 32);
+ * ctr.setIV(iv, 16);
+ * ctr.setCounterSize(4);
+ * ctr.encrypt(output, input, len);
+ * \endcode
+ *
+ * \sa CTRCommon, GCM
+ */
+
+/**
+ * \fn CTR::CTR()
+ * \brief Constructs a new CTR object for the 128-bit block cipher T.
+ */
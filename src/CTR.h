@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 Operator Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CRYPTO_CTR_h
+#define CRYPTO_CTR_h
+
+#include "Cipher.h"
+#include "BlockCipher.h"
+
+// Size in bytes of the keystream ring buffer in each CTR object.  Must be
+// a multiple of 16.  The default of four blocks lets a whole buffer be
+// encrypted in one multi-block call; raise it to cover a larger packet
+// with keystream that was computed ahead of time.
+#if !defined(CRYPTO_CTR_BUFFER_SIZE)
+#define CRYPTO_CTR_BUFFER_SIZE 64
+#endif
+#if (CRYPTO_CTR_BUFFER_SIZE % 16) != 0 || CRYPTO_CTR_BUFFER_SIZE == 0
+#error "CRYPTO_CTR_BUFFER_SIZE must be a non-zero multiple of 16"
+#endif
+
+class CTRCommon : public Cipher
+{
+public:
+    virtual ~CTRCommon();
+
+    size_t keySize() const;
+    size_t ivSize() const;
+
+    bool setCounterSize(size_t size);
+
+    bool setKey(const uint8_t *key, size_t len);
+    void setKeySlot(int slot);
+    bool setIV(const uint8_t *iv, size_t len);
+
+    void encrypt(uint8_t *output, const uint8_t *input, size_t len);
+    void decrypt(uint8_t *output, const uint8_t *input, size_t len);
+
+    size_t precompute(size_t len = CRYPTO_CTR_BUFFER_SIZE);
+    size_t available() const { return avail; }
+
+    void clear();
+
+protected:
+    CTRCommon();
+    void setBlockCipher(BlockCipher *cipher) { blockCipher = cipher; }
+
+private:
+    BlockCipher *blockCipher;
+    uint8_t counter[16];
+    uint8_t buffer[CRYPTO_CTR_BUFFER_SIZE];
+    size_t posn;
+    size_t avail;
+    uint8_t counterStart;
+    int8_t slot;
+
+    void discard();
+    void rewind(size_t blocks);
+    void increment();
+};
+
+template <typename T>
+class CTR : public CTRCommon
+{
+public:
+    CTR() { setBlockCipher(&cipher); }
+
+private:
+    T cipher;
+};
+
+#endif
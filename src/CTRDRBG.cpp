@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2026 Operator Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "CTRDRBG.h"
+#include "Crypto.h"
+#include <string.h>
+
+// min() and friends take their arguments by reference, which needs a
+// definition to bind to.
+const size_t CTRDRBG::MAX_REQUEST;
+
+/**
+ * \class CTRDRBG CTRDRBG.h <CTRDRBG.h>
+ * \brief CTR_DRBG deterministic random bit generator using AES-256.
+ *
+ * This is the CTR_DRBG construction from NIST SP 800-90A without a
+ * derivation function, so the entropy input passed to reseed() must be
+ * SEED_SIZE bytes of full entropy.  Once seeded, output is produced by
+ * encrypting a counter in software, so it is limited only by the speed of
+ * the local AES implementation.
+ *
+ * The generator refuses to produce output before the first reseed() and
+ * after reseed interval requests have been served, at which point the
+ * caller must supply fresh entropy.  ECCX08Class::useDRBG() connects a
+ * generator to the ECCX08 chip, which then seeds it automatically.
+ *
+ * Reference: <a href="https://csrc.nist.gov/publications/detail/sp/800-90a/rev-1/final">NIST SP 800-90A Rev. 1</a>
+ *
+ * \sa ECCX08Class::useDRBG()
+ */
+
+/**
+ * \brief Constructs a new CTR_DRBG that has not been seeded yet.
+ */
+CTRDRBG::CTRDRBG()
+    : reseedCounter(0)
+    , reseedInterval(1024)
+{
+    memset(V, 0, sizeof(V));
+}
+
+/**
+ * \brief Destroys this CTR_DRBG and clears its internal state.
+ */
+CTRDRBG::~CTRDRBG()
+{
+    clean(V);
+}
+
+/**
+ * \brief Reseeds the generator with fresh entropy.
+ *
+ * \param entropy Points to SEED_SIZE bytes of entropy input.
+ * \param additional Optional additional input, or personalization string
+ * on the first call.
+ * \param len Length of \a additional, at most SEED_SIZE bytes.  Extra
+ * bytes are ignored.
+ *
+ * The first call instantiates the generator.
+ */
+void CTRDRBG::reseed(const uint8_t *entropy, const uint8_t *additional, size_t len)
+{
+    uint8_t seed[SEED_SIZE];
+
+    if (!reseedCounter) {
+        // Instantiate: start from an all-zero key and V.
+        uint8_t key[32];
+        memset(key, 0, sizeof(key));
+        cipher.setKey(key, sizeof(key));
+        memset(V, 0, sizeof(V));
+    }
+
+    memcpy(seed, entropy, SEED_SIZE);
+    if (len > SEED_SIZE)
+        len = SEED_SIZE;
+    for (size_t i = 0; i < len; ++i)
+        seed[i] ^= additional[i];
+
+    update(seed);
+    reseedCounter = 1;
+
+    clean(seed);
+}
+
+/**
+ * \brief Generates random bytes.
+ *
+ * \param data Buffer to fill with random bytes.
+ * \param len Number of bytes to generate, at most MAX_REQUEST.
+ *
+ * \return Returns false without generating anything if the generator has
+ * not been seeded yet, needs to be reseeded, or \a len is too large.
+ *
+ * \sa reseed(), setReseedInterval()
+ */
+bool CTRDRBG::generate(uint8_t *data, size_t len)
+{
+    if (!reseedCounter || reseedCounter > reseedInterval || len > MAX_REQUEST)
+        return false;
+
+    while (len >= 16) {
+        nextBlock(data);
+        data += 16;
+        len -= 16;
+    }
+
+    if (len > 0) {
+        uint8_t block[16];
+        nextBlock(block);
+        memcpy(data, block, len);
+        clean(block);
+    }
+
+    // Move to a new key and V so that earlier output cannot be recovered
+    // from the state (backtracking resistance).
+    uint8_t zeroes[SEED_SIZE];
+    memset(zeroes, 0, sizeof(zeroes));
+    update(zeroes);
+
+    ++reseedCounter;
+    return true;
+}
+
+/**
+ * \brief Sets the number of generate() requests between reseeds.
+ *
+ * \param requests The number of requests, the default is 1024.  SP 800-90A
+ * allows up to 2^48 for AES.
+ */
+void CTRDRBG::setReseedInterval(uint32_t requests)
+{
+    reseedInterval = requests;
+}
+
+/**
+ * \brief Clears the internal state, after which the generator must be
+ * reseeded before it can be used again.
+ */
+void CTRDRBG::clear()
+{
+    cipher.clear();
+    clean(V);
+    reseedCounter = 0;
+}
+
+/**
+ * \brief Increments V as a 128-bit big endian counter and encrypts it.
+ */
+void CTRDRBG::nextBlock(uint8_t *output)
+{
+    for (uint8_t i = 16; i > 0; --i) {
+        if (++V[i - 1] != 0)
+            break;
+    }
+    cipher.encryptBlock(output, V);
+}
+
+/**
+ * \brief The CTR_DRBG_Update function from SP 800-90A.
+ *
+ * \param provided Points to SEED_SIZE bytes of provided data.
+ */
+void CTRDRBG::update(const uint8_t *provided)
+{
+    uint8_t temp[SEED_SIZE];
+
+    nextBlock(temp);
+    nextBlock(temp + 16);
+    nextBlock(temp + 32);
+    for (uint8_t i = 0; i < SEED_SIZE; ++i)
+        temp[i] ^= provided[i];
+
+    cipher.setKey(temp, 32);
+    memcpy(V, temp + 32, 16);
+
+    clean(temp);
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2026 Operator Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CRYPTO_CTRDRBG_h
+#define CRYPTO_CTRDRBG_h
+
+#include "AES.h"
+
+class CTRDRBG
+{
+public:
+    CTRDRBG();
+    ~CTRDRBG();
+
+    /** Size of the entropy input to reseed(): a 256-bit key and a block */
+    static const size_t SEED_SIZE = 48;
+
+    /** Largest number of bytes that one generate() request may return:
+        64K as allowed by SP 800-90A, or 32K where size_t is 16 bits */
+    static const size_t MAX_REQUEST = (sizeof(size_t) > 2) ? 65536UL : 32768U;
+
+    void reseed(const uint8_t *entropy, const uint8_t *additional = 0, size_t len = 0);
+    bool generate(uint8_t *data, size_t len);
+
+    void setReseedInterval(uint32_t requests);
+
+    void clear();
+
+private:
+    AES256 cipher;
+    uint8_t V[16];
+    uint32_t reseedCounter;
+    uint32_t reseedInterval;
+
+    void update(const uint8_t *provided);
+    void nextBlock(uint8_t *output);
+};
+
+#endif
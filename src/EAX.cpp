@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2026 Operator Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "EAX.h"
+#include "Crypto.h"
+#include <string.h>
+
+/**
+ * \class EAXCommon EAX.h <EAX.h>
+ * \brief Concrete base class to assist with implementing EAX for
+ * 128-bit block ciphers.
+ *
+ * EAX combines counter mode with three OMAC hashes: one of the nonce,
+ * one of the authenticated data and one of the ciphertext.  Unlike GCM
+ * it only ever uses the encrypt direction of the block cipher and needs
+ * no multiplication tables, so EAX<AESTiny128> runs in about 100 bytes
+ * of state plus the key schedule.  That makes it a good fit for boards
+ * that are short on RAM and do not want GHASH bound to the chip.
+ *
+ * The nonce can be any length; 16 bytes is recommended.  As with GCM,
+ * all authenticated data must be added before the first call to
+ * encrypt() or decrypt().
+ *
+ * References: https://en.wikipedia.org/wiki/EAX_mode,
+ * http://web.cs.ucdavis.edu/~rogaway/papers/eax.html
+ *
+ * \sa EAX, OMAC, GCM
+ */
+
+/**
+ * \brief Constructs a new cipher in EAX mode.
+ *
+ * This constructor must be followed by a call to setBlockCipher().
+ */
+EAXCommon::EAXCommon()
+{
+    state.encPosn = 16;
+    state.authMode = false;
+}
+
+/**
+ * \brief Destroys this cipher object after clearing sensitive information.
+ */
+EAXCommon::~EAXCommon()
+{
+    clean(state);
+}
+
+size_t EAXCommon::keySize() const
+{
+    return omac.blockCipher()->keySize();
+}
+
+size_t EAXCommon::ivSize() const
+{
+    return 16;
+}
+
+size_t EAXCommon::tagSize() const
+{
+    return 16;
+}
+
+bool EAXCommon::setKey(const uint8_t *key, size_t len)
+{
+    if (!omac.blockCipher()->setKey(key, len))
+        return false;
+    omac.initKey();
+    return true;
+}
+
+bool EAXCommon::setIV(const uint8_t *iv, size_t len)
+{
+    // Hash the nonce to get the initial counter value N.
+    omac.init(state.nonce, 0);
+    omac.update(state.nonce, iv, len);
+    omac.finalize(state.nonce);
+    memcpy(state.counter, state.nonce, 16);
+    state.encPosn = 16;
+
+    // Start hashing the authenticated data.
+    omac.init(state.hash, 1);
+    state.authMode = true;
+    return true;
+}
+
+void EAXCommon::encrypt(uint8_t *output, const uint8_t *input, size_t len)
+{
+    closeAuthData();
+    encryptCTR(output, input, len);
+    omac.update(state.tag, output, len);
+}
+
+void EAXCommon::decrypt(uint8_t *output, const uint8_t *input, size_t len)
+{
+    // Hash the ciphertext first in case we are decrypting in place.
+    closeAuthData();
+    omac.update(state.tag, input, len);
+    encryptCTR(output, input, len);
+}
+
+void EAXCommon::addAuthData(const void *data, size_t len)
+{
+    if (state.authMode)
+        omac.update(state.hash, (const uint8_t *)data, len);
+}
+
+void EAXCommon::computeTag(void *tag, size_t len)
+{
+    // The tag is N ^ H ^ C for the three OMAC values.
+    closeAuthData();
+    omac.finalize(state.tag);
+    for (uint8_t index = 0; index < 4; ++index)
+        state.tag[index] ^= state.nonce[index] ^ state.hash[index];
+    if (len > 16)
+        len = 16;
+    memcpy(tag, state.tag, len);
+}
+
+bool EAXCommon::checkTag(const void *tag, size_t len)
+{
+    // Can never match if the expected tag length is too long.
+    if (len > 16)
+        return false;
+
+    // Compute the tag and check it.
+    computeTag(state.counter, 16);
+    return secure_compare(state.counter, tag, len);
+}
+
+void EAXCommon::clear()
+{
+    omac.blockCipher()->clear();
+    omac.clear();
+    clean(state);
+    state.encPosn = 16;
+    state.authMode = false;
+}
+
+/**
+ * \brief Closes the authenticated data hash and starts the ciphertext hash.
+ */
+void EAXCommon::closeAuthData()
+{
+    if (state.authMode) {
+        omac.finalize(state.hash);
+        omac.init(state.tag, 2);
+        state.authMode = false;
+    }
+}
+
+/**
+ * \brief Encrypts or decrypts data in counter mode.
+ *
+ * \param output The output buffer.
+ * \param input The input buffer, which may be the same as \a output.
+ * \param len The number of bytes to process.
+ */
+void EAXCommon::encryptCTR(uint8_t *output, const uint8_t *input, size_t len)
+{
+    while (len > 0) {
+        // Create a new keystream block if necessary.
+        if (state.encPosn == 16) {
+            omac.blockCipher()->encryptBlock
+                ((uint8_t *)state.stream, (uint8_t *)state.counter);
+
+            // The whole 128-bit counter is incremented as a big-endian
+            // number.
+            uint16_t temp = 1;
+            for (uint8_t index = 16; index > 0; ) {
+                --index;
+                temp += ((uint8_t *)state.counter)[index];
+                ((uint8_t *)state.counter)[index] = (uint8_t)temp;
+                temp >>= 8;
+            }
+            state.encPosn = 0;
+        }
+
+        // XOR as many bytes as we can using the keystream block.
+        uint8_t size = 16 - state.encPosn;
+        if (size > len)
+            size = (uint8_t)len;
+        const uint8_t *stream = ((const uint8_t *)state.stream) + state.encPosn;
+        for (uint8_t index = 0; index < size; ++index)
+            output[index] = input[index] ^ stream[index];
+        state.encPosn += size;
+        output += size;
+        input += size;
+        len -= size;
+    }
+}
+
+/**
+ * \class EAX EAX.h <EAX.h>
+ * \brief Implementation of the EAX authenticated cipher.
+ *
+ * The template parameter T must be a concrete subclass of BlockCipher
+ * indicating the specific block cipher to use.  T must have a block size
+ * of 16 bytes (128 bits).  Only encryptBlock() is used, so the AESTiny
+ * classes are enough:
+ *
+ * \code
+ * EAX<AESTiny128> eax;
+ * eax.setKey(key, 16);
+ * eax.setIV(nonce, 16);
+ * eax.addAuthData(header, headerLen);
+ * eax.encrypt(output, input, len);
+ * eax.computeTag(tag, 16);
+ * \endcode
+ *
+ * \sa EAXCommon, GCM
+ */
+
+/**
+ * \fn EAX::EAX()
+ * \brief Constructs a new EAX object for the block cipher T.
+ */
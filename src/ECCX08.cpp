@@ -20,6 +20,8 @@
 #include <Arduino.h>
 
 #include "ECCX08.h"
+#include "CTRDRBG.h"
+#include "utility/ProgMemUtil.h"
 
 #include <cstring>
 
@@ -30,26 +32,228 @@ const uint32_t ECCX08Class::_normalFrequency = 400000u;  // 400 kHz
 const uint32_t ECCX08Class::_normalFrequency = 1000000u; // 1 MHz
 #endif
 
-ECCX08Class::ECCX08Class(TwoWire& wire, uint8_t address) :
-  _wire(&wire),
-  _address(address)
+// typical and maximum execution times in ms for the ATECC508A and ATECC608A,
+// the typical time is waited out before the device is polled for a response
+static constexpr struct {
+  uint8_t opcode;
+  uint8_t typical[2];
+  uint8_t maximum[2];
+} executionTimes[] = {
+  // opcode              typical      maximum
+  { 0x02 /* Read */,    {  0,  0 }, {   5,   5 } },
+  { 0x12 /* Write */,   {  7,  7 }, {  26,  45 } },
+  { 0x16 /* Nonce */,   {  0,  0 }, {  29,  29 } },
+  { 0x17 /* Lock */,    {  8,  8 }, {  32,  35 } },
+  { 0x1b /* Random */,  {  1,  1 }, {  23,  23 } },
+  { 0x30 /* Info */,    {  0,  0 }, {   2,   5 } },
+  { 0x40 /* GenKey */,  { 11, 11 }, { 115, 115 } },
+  { 0x41 /* Sign */,    { 42, 38 }, {  70, 115 } },
+  { 0x43 /* ECDH */,    { 38, 38 }, {  58,  75 } },
+  { 0x45 /* Verify */,  { 38, 38 }, {  72, 105 } },
+  { 0x47 /* SHA */,     {  7,  0 }, {   9,  36 } },
+  { 0x51 /* AES */,     {  0,  0 }, {  27,  27 } },
+};
+
+// The device uses CRC-16 with polynomial 0x8005, feeding the data in least
+// significant bit first but without reflecting the result.  That is the
+// reflected CRC-16/ARC with its 16 bit result reversed, which lets us use the
+// usual byte-wise table driven form.  32-bit targets also get the tables for
+// slicing by 4, AVR keeps to the single table in flash.
+#if defined(__AVR__)
+#define CRC16_SLICES 1
+#else
+#define CRC16_SLICES 4
+#endif
+
+static const uint16_t crc16Table[CRC16_SLICES][256] PROGMEM = {
+  {
+    0x0000, 0xc0c1, 0xc181, 0x0140, 0xc301, 0x03c0, 0x0280, 0xc241,
+    0xc601, 0x06c0, 0x0780, 0xc741, 0x0500, 0xc5c1, 0xc481, 0x0440,
+    0xcc01, 0x0cc0, 0x0d80, 0xcd41, 0x0f00, 0xcfc1, 0xce81, 0x0e40,
+    0x0a00, 0xcac1, 0xcb81, 0x0b40, 0xc901, 0x09c0, 0x0880, 0xc841,
+    0xd801, 0x18c0, 0x1980, 0xd941, 0x1b00, 0xdbc1, 0xda81, 0x1a40,
+    0x1e00, 0xdec1, 0xdf81, 0x1f40, 0xdd01, 0x1dc0, 0x1c80, 0xdc41,
+    0x1400, 0xd4c1, 0xd581, 0x1540, 0xd701, 0x17c0, 0x1680, 0xd641,
+    0xd201, 0x12c0, 0x1380, 0xd341, 0x1100, 0xd1c1, 0xd081, 0x1040,
+    0xf001, 0x30c0, 0x3180, 0xf141, 0x3300, 0xf3c1, 0xf281, 0x3240,
+    0x3600, 0xf6c1, 0xf781, 0x3740, 0xf501, 0x35c0, 0x3480, 0xf441,
+    0x3c00, 0xfcc1, 0xfd81, 0x3d40, 0xff01, 0x3fc0, 0x3e80, 0xfe41,
+    0xfa01, 0x3ac0, 0x3b80, 0xfb41, 0x3900, 0xf9c1, 0xf881, 0x3840,
+    0x2800, 0xe8c1, 0xe981, 0x2940, 0xeb01, 0x2bc0, 0x2a80, 0xea41,
+    0xee01, 0x2ec0, 0x2f80, 0xef41, 0x2d00, 0xedc1, 0xec81, 0x2c40,
+    0xe401, 0x24c0, 0x2580, 0xe541, 0x2700, 0xe7c1, 0xe681, 0x2640,
+    0x2200, 0xe2c1, 0xe381, 0x2340, 0xe101, 0x21c0, 0x2080, 0xe041,
+    0xa001, 0x60c0, 0x6180, 0xa141, 0x6300, 0xa3c1, 0xa281, 0x6240,
+    0x6600, 0xa6c1, 0xa781, 0x6740, 0xa501, 0x65c0, 0x6480, 0xa441,
+    0x6c00, 0xacc1, 0xad81, 0x6d40, 0xaf01, 0x6fc0, 0x6e80, 0xae41,
+    0xaa01, 0x6ac0, 0x6b80, 0xab41, 0x6900, 0xa9c1, 0xa881, 0x6840,
+    0x7800, 0xb8c1, 0xb981, 0x7940, 0xbb01, 0x7bc0, 0x7a80, 0xba41,
+    0xbe01, 0x7ec0, 0x7f80, 0xbf41, 0x7d00, 0xbdc1, 0xbc81, 0x7c40,
+    0xb401, 0x74c0, 0x7580, 0xb541, 0x7700, 0xb7c1, 0xb681, 0x7640,
+    0x7200, 0xb2c1, 0xb381, 0x7340, 0xb101, 0x71c0, 0x7080, 0xb041,
+    0x5000, 0x90c1, 0x9181, 0x5140, 0x9301, 0x53c0, 0x5280, 0x9241,
+    0x9601, 0x56c0, 0x5780, 0x9741, 0x5500, 0x95c1, 0x9481, 0x5440,
+    0x9c01, 0x5cc0, 0x5d80, 0x9d41, 0x5f00, 0x9fc1, 0x9e81, 0x5e40,
+    0x5a00, 0x9ac1, 0x9b81, 0x5b40, 0x9901, 0x59c0, 0x5880, 0x9841,
+    0x8801, 0x48c0, 0x4980, 0x8941, 0x4b00, 0x8bc1, 0x8a81, 0x4a40,
+    0x4e00, 0x8ec1, 0x8f81, 0x4f40, 0x8d01, 0x4dc0, 0x4c80, 0x8c41,
+    0x4400, 0x84c1, 0x8581, 0x4540, 0x8701, 0x47c0, 0x4680, 0x8641,
+    0x8201, 0x42c0, 0x4380, 0x8341, 0x4100, 0x81c1, 0x8081, 0x4040
+  },
+#if CRC16_SLICES == 4
+  {
+    0x0000, 0x9001, 0x6001, 0xf000, 0xc002, 0x5003, 0xa003, 0x3002,
+    0xc007, 0x5006, 0xa006, 0x3007, 0x0005, 0x9004, 0x6004, 0xf005,
+    0xc00d, 0x500c, 0xa00c, 0x300d, 0x000f, 0x900e, 0x600e, 0xf00f,
+    0x000a, 0x900b, 0x600b, 0xf00a, 0xc008, 0x5009, 0xa009, 0x3008,
+    0xc019, 0x5018, 0xa018, 0x3019, 0x001b, 0x901a, 0x601a, 0xf01b,
+    0x001e, 0x901f, 0x601f, 0xf01e, 0xc01c, 0x501d, 0xa01d, 0x301c,
+    0x0014, 0x9015, 0x6015, 0xf014, 0xc016, 0x5017, 0xa017, 0x3016,
+    0xc013, 0x5012, 0xa012, 0x3013, 0x0011, 0x9010, 0x6010, 0xf011,
+    0xc031, 0x5030, 0xa030, 0x3031, 0x0033, 0x9032, 0x6032, 0xf033,
+    0x0036, 0x9037, 0x6037, 0xf036, 0xc034, 0x5035, 0xa035, 0x3034,
+    0x003c, 0x903d, 0x603d, 0xf03c, 0xc03e, 0x503f, 0xa03f, 0x303e,
+    0xc03b, 0x503a, 0xa03a, 0x303b, 0x0039, 0x9038, 0x6038, 0xf039,
+    0x0028, 0x9029, 0x6029, 0xf028, 0xc02a, 0x502b, 0xa02b, 0x302a,
+    0xc02f, 0x502e, 0xa02e, 0x302f, 0x002d, 0x902c, 0x602c, 0xf02d,
+    0xc025, 0x5024, 0xa024, 0x3025, 0x0027, 0x9026, 0x6026, 0xf027,
+    0x0022, 0x9023, 0x6023, 0xf022, 0xc020, 0x5021, 0xa021, 0x3020,
+    0xc061, 0x5060, 0xa060, 0x3061, 0x0063, 0x9062, 0x6062, 0xf063,
+    0x0066, 0x9067, 0x6067, 0xf066, 0xc064, 0x5065, 0xa065, 0x3064,
+    0x006c, 0x906d, 0x606d, 0xf06c, 0xc06e, 0x506f, 0xa06f, 0x306e,
+    0xc06b, 0x506a, 0xa06a, 0x306b, 0x0069, 0x9068, 0x6068, 0xf069,
+    0x0078, 0x9079, 0x6079, 0xf078, 0xc07a, 0x507b, 0xa07b, 0x307a,
+    0xc07f, 0x507e, 0xa07e, 0x307f, 0x007d, 0x907c, 0x607c, 0xf07d,
+    0xc075, 0x5074, 0xa074, 0x3075, 0x0077, 0x9076, 0x6076, 0xf077,
+    0x0072, 0x9073, 0x6073, 0xf072, 0xc070, 0x5071, 0xa071, 0x3070,
+    0x0050, 0x9051, 0x6051, 0xf050, 0xc052, 0x5053, 0xa053, 0x3052,
+    0xc057, 0x5056, 0xa056, 0x3057, 0x0055, 0x9054, 0x6054, 0xf055,
+    0xc05d, 0x505c, 0xa05c, 0x305d, 0x005f, 0x905e, 0x605e, 0xf05f,
+    0x005a, 0x905b, 0x605b, 0xf05a, 0xc058, 0x5059, 0xa059, 0x3058,
+    0xc049, 0x5048, 0xa048, 0x3049, 0x004b, 0x904a, 0x604a, 0xf04b,
+    0x004e, 0x904f, 0x604f, 0xf04e, 0xc04c, 0x504d, 0xa04d, 0x304c,
+    0x0044, 0x9045, 0x6045, 0xf044, 0xc046, 0x5047, 0xa047, 0x3046,
+    0xc043, 0x5042, 0xa042, 0x3043, 0x0041, 0x9040, 0x6040, 0xf041
+  },
+  {
+    0x0000, 0xc051, 0xc0a1, 0x00f0, 0xc141, 0x0110, 0x01e0, 0xc1b1,
+    0xc281, 0x02d0, 0x0220, 0xc271, 0x03c0, 0xc391, 0xc361, 0x0330,
+    0xc501, 0x0550, 0x05a0, 0xc5f1, 0x0440, 0xc411, 0xc4e1, 0x04b0,
+    0x0780, 0xc7d1, 0xc721, 0x0770, 0xc6c1, 0x0690, 0x0660, 0xc631,
+    0xca01, 0x0a50, 0x0aa0, 0xcaf1, 0x0b40, 0xcb11, 0xcbe1, 0x0bb0,
+    0x0880, 0xc8d1, 0xc821, 0x0870, 0xc9c1, 0x0990, 0x0960, 0xc931,
+    0x0f00, 0xcf51, 0xcfa1, 0x0ff0, 0xce41, 0x0e10, 0x0ee0, 0xceb1,
+    0xcd81, 0x0dd0, 0x0d20, 0xcd71, 0x0cc0, 0xcc91, 0xcc61, 0x0c30,
+    0xd401, 0x1450, 0x14a0, 0xd4f1, 0x1540, 0xd511, 0xd5e1, 0x15b0,
+    0x1680, 0xd6d1, 0xd621, 0x1670, 0xd7c1, 0x1790, 0x1760, 0xd731,
+    0x1100, 0xd151, 0xd1a1, 0x11f0, 0xd041, 0x1010, 0x10e0, 0xd0b1,
+    0xd381, 0x13d0, 0x1320, 0xd371, 0x12c0, 0xd291, 0xd261, 0x1230,
+    0x1e00, 0xde51, 0xdea1, 0x1ef0, 0xdf41, 0x1f10, 0x1fe0, 0xdfb1,
+    0xdc81, 0x1cd0, 0x1c20, 0xdc71, 0x1dc0, 0xdd91, 0xdd61, 0x1d30,
+    0xdb01, 0x1b50, 0x1ba0, 0xdbf1, 0x1a40, 0xda11, 0xdae1, 0x1ab0,
+    0x1980, 0xd9d1, 0xd921, 0x1970, 0xd8c1, 0x1890, 0x1860, 0xd831,
+    0xe801, 0x2850, 0x28a0, 0xe8f1, 0x2940, 0xe911, 0xe9e1, 0x29b0,
+    0x2a80, 0xead1, 0xea21, 0x2a70, 0xebc1, 0x2b90, 0x2b60, 0xeb31,
+    0x2d00, 0xed51, 0xeda1, 0x2df0, 0xec41, 0x2c10, 0x2ce0, 0xecb1,
+    0xef81, 0x2fd0, 0x2f20, 0xef71, 0x2ec0, 0xee91, 0xee61, 0x2e30,
+    0x2200, 0xe251, 0xe2a1, 0x22f0, 0xe341, 0x2310, 0x23e0, 0xe3b1,
+    0xe081, 0x20d0, 0x2020, 0xe071, 0x21c0, 0xe191, 0xe161, 0x2130,
+    0xe701, 0x2750, 0x27a0, 0xe7f1, 0x2640, 0xe611, 0xe6e1, 0x26b0,
+    0x2580, 0xe5d1, 0xe521, 0x2570, 0xe4c1, 0x2490, 0x2460, 0xe431,
+    0x3c00, 0xfc51, 0xfca1, 0x3cf0, 0xfd41, 0x3d10, 0x3de0, 0xfdb1,
+    0xfe81, 0x3ed0, 0x3e20, 0xfe71, 0x3fc0, 0xff91, 0xff61, 0x3f30,
+    0xf901, 0x3950, 0x39a0, 0xf9f1, 0x3840, 0xf811, 0xf8e1, 0x38b0,
+    0x3b80, 0xfbd1, 0xfb21, 0x3b70, 0xfac1, 0x3a90, 0x3a60, 0xfa31,
+    0xf601, 0x3650, 0x36a0, 0xf6f1, 0x3740, 0xf711, 0xf7e1, 0x37b0,
+    0x3480, 0xf4d1, 0xf421, 0x3470, 0xf5c1, 0x3590, 0x3560, 0xf531,
+    0x3300, 0xf351, 0xf3a1, 0x33f0, 0xf241, 0x3210, 0x32e0, 0xf2b1,
+    0xf181, 0x31d0, 0x3120, 0xf171, 0x30c0, 0xf091, 0xf061, 0x3030
+  },
+  {
+    0x0000, 0xfc01, 0xb801, 0x4400, 0x3001, 0xcc00, 0x8800, 0x7401,
+    0x6002, 0x9c03, 0xd803, 0x2402, 0x5003, 0xac02, 0xe802, 0x1403,
+    0xc004, 0x3c05, 0x7805, 0x8404, 0xf005, 0x0c04, 0x4804, 0xb405,
+    0xa006, 0x5c07, 0x1807, 0xe406, 0x9007, 0x6c06, 0x2806, 0xd407,
+    0xc00b, 0x3c0a, 0x780a, 0x840b, 0xf00a, 0x0c0b, 0x480b, 0xb40a,
+    0xa009, 0x5c08, 0x1808, 0xe409, 0x9008, 0x6c09, 0x2809, 0xd408,
+    0x000f, 0xfc0e, 0xb80e, 0x440f, 0x300e, 0xcc0f, 0x880f, 0x740e,
+    0x600d, 0x9c0c, 0xd80c, 0x240d, 0x500c, 0xac0d, 0xe80d, 0x140c,
+    0xc015, 0x3c14, 0x7814, 0x8415, 0xf014, 0x0c15, 0x4815, 0xb414,
+    0xa017, 0x5c16, 0x1816, 0xe417, 0x9016, 0x6c17, 0x2817, 0xd416,
+    0x0011, 0xfc10, 0xb810, 0x4411, 0x3010, 0xcc11, 0x8811, 0x7410,
+    0x6013, 0x9c12, 0xd812, 0x2413, 0x5012, 0xac13, 0xe813, 0x1412,
+    0x001e, 0xfc1f, 0xb81f, 0x441e, 0x301f, 0xcc1e, 0x881e, 0x741f,
+    0x601c, 0x9c1d, 0xd81d, 0x241c, 0x501d, 0xac1c, 0xe81c, 0x141d,
+    0xc01a, 0x3c1b, 0x781b, 0x841a, 0xf01b, 0x0c1a, 0x481a, 0xb41b,
+    0xa018, 0x5c19, 0x1819, 0xe418, 0x9019, 0x6c18, 0x2818, 0xd419,
+    0xc029, 0x3c28, 0x7828, 0x8429, 0xf028, 0x0c29, 0x4829, 0xb428,
+    0xa02b, 0x5c2a, 0x182a, 0xe42b, 0x902a, 0x6c2b, 0x282b, 0xd42a,
+    0x002d, 0xfc2c, 0xb82c, 0x442d, 0x302c, 0xcc2d, 0x882d, 0x742c,
+    0x602f, 0x9c2e, 0xd82e, 0x242f, 0x502e, 0xac2f, 0xe82f, 0x142e,
+    0x0022, 0xfc23, 0xb823, 0x4422, 0x3023, 0xcc22, 0x8822, 0x7423,
+    0x6020, 0x9c21, 0xd821, 0x2420, 0x5021, 0xac20, 0xe820, 0x1421,
+    0xc026, 0x3c27, 0x7827, 0x8426, 0xf027, 0x0c26, 0x4826, 0xb427,
+    0xa024, 0x5c25, 0x1825, 0xe424, 0x9025, 0x6c24, 0x2824, 0xd425,
+    0x003c, 0xfc3d, 0xb83d, 0x443c, 0x303d, 0xcc3c, 0x883c, 0x743d,
+    0x603e, 0x9c3f, 0xd83f, 0x243e, 0x503f, 0xac3e, 0xe83e, 0x143f,
+    0xc038, 0x3c39, 0x7839, 0x8438, 0xf039, 0x0c38, 0x4838, 0xb439,
+    0xa03a, 0x5c3b, 0x183b, 0xe43a, 0x903b, 0x6c3a, 0x283a, 0xd43b,
+    0xc037, 0x3c36, 0x7836, 0x8437, 0xf036, 0x0c37, 0x4837, 0xb436,
+    0xa035, 0x5c34, 0x1834, 0xe435, 0x9034, 0x6c35, 0x2835, 0xd434,
+    0x0033, 0xfc32, 0xb832, 0x4433, 0x3032, 0xcc33, 0x8833, 0x7432,
+    0x6031, 0x9c30, 0xd830, 0x2431, 0x5030, 0xac31, 0xe831, 0x1430
+  },
+#endif
+};
+
+// used for opcodes missing from the table above
+static const uint8_t defaultMaximumExecutionTime = 250;
+
+// the watchdog sends the device to sleep 0.7 - 1.7 s after it wakes up, no
+// matter what it is doing, so a session re-wakes it once this much time is left
+static const unsigned long watchdogTimeout = 700;
+static const unsigned long watchdogMargin = defaultMaximumExecutionTime;
+
+ECCX08Class::ECCX08Class(ECCX08Transport& transport, uint8_t address) :
+  _transport(&transport),
+  _ownedTransport(NULL),
+  _address(address),
+  _revision(-1),
+  _commandLength(0),
+  _commandCrc(0),
+  _commandStart(0),
+  _commandTypical(0),
+  _commandMaximum(0),
+  _sessionDepth(0),
+  _awake(false),
+  _wakeTime(0),
+  _asyncState(ASYNC_IDLE),
+  _asyncHandle(0),
+  _asyncLength(0),
+  _entropyLength(0),
+  _drbg(NULL)
 {
 }
 
 ECCX08Class::~ECCX08Class()
 {
+  delete _ownedTransport;
 }
 
 int ECCX08Class::begin()
 {
-  _wire->begin();
+  _transport->begin();
 
   wakeup();
   idle();
   
   long ver = version() & 0x0F00000;
 
-  if (ver != 0x0500000 && ver != 0x0600000) {
+  if (ver == 0x0500000) {
+    _revision = 0; // ATECC508A
+  } else if (ver == 0x0600000) {
+    _revision = 1; // ATECC608A
+  } else {
     return 0;
   }
 
@@ -61,13 +265,30 @@ void ECCX08Class::end()
   // First wake up the device otherwise the chip didn't react to a sleep commando
   wakeup();
   sleep();
-#ifdef WIRE_HAS_END
-  _wire->end();
-#endif
+  _transport->end();
+}
+
+void ECCX08Class::beginSession()
+{
+  _sessionDepth++;
+}
+
+void ECCX08Class::endSession()
+{
+  if (_sessionDepth == 0 || --_sessionDepth > 0) {
+    return;
+  }
+
+  if (_awake) {
+    delay(1);
+    idle();
+  }
 }
 
 int ECCX08Class::serialNumber(byte sn[])
 {
+  ECCX08Session session(*this);
+
   if (!read(0, 0, &sn[0], 4)) {
     return 0;
   }
@@ -136,7 +357,55 @@ long ECCX08Class::random(long min, long max)
 
 int ECCX08Class::random(byte data[], size_t length)
 {
-  if (!wakeup()) {
+  if (_drbg == NULL) {
+    return chipRandom(data, length);
+  }
+
+  while (length) {
+    size_t chunkSize = min(length, CTRDRBG::MAX_REQUEST);
+
+    if (!_drbg->generate(data, chunkSize)) {
+      // not seeded yet or due for a reseed
+      byte seed[CTRDRBG::SEED_SIZE];
+
+      if (!chipRandom(seed, sizeof(seed))) {
+        return 0;
+      }
+
+      _drbg->reseed(seed);
+      memset(seed, 0x00, sizeof(seed));
+
+      if (!_drbg->generate(data, chunkSize)) {
+        return 0;
+      }
+    }
+
+    length -= chunkSize;
+    data += chunkSize;
+  }
+
+  return 1;
+}
+
+void ECCX08Class::useDRBG(CTRDRBG* drbg)
+{
+  _drbg = drbg;
+}
+
+int ECCX08Class::chipRandom(byte data[], size_t length)
+{
+  // use up what is left over from the last Random command first
+  size_t pooled = min(length, (size_t)_entropyLength);
+
+  takeEntropy(data, pooled);
+  data += pooled;
+  length -= pooled;
+
+  if (length == 0) {
+    return 1;
+  }
+
+  if (!acquire()) {
     return 0;
   }
 
@@ -145,31 +414,46 @@ int ECCX08Class::random(byte data[], size_t length)
       return 0;
     }
 
-    delay(23);
+    if (length >= sizeof(_entropy)) {
+      // whole responses go straight to the caller
+      if (!receiveResponse(data, sizeof(_entropy))) {
+        return 0;
+      }
+
+      data += sizeof(_entropy);
+      length -= sizeof(_entropy);
+    } else {
+      // keep the rest for the next call
+      if (!receiveResponse(_entropy, sizeof(_entropy))) {
+        return 0;
+      }
 
-    byte response[32];
+      _entropyLength = sizeof(_entropy);
 
-    if (!receiveResponse(response, sizeof(response))) {
-      return 0;
+      takeEntropy(data, length);
+      length = 0;
     }
+  }
 
-    int copyLength = min(32, (int)length);
-    memcpy(data, response, copyLength);
+  release();
 
-    length -= copyLength;
-    data += copyLength;
-  }
+  return 1;
+}
 
-  delay(1);
+void ECCX08Class::takeEntropy(byte data[], size_t length)
+{
+  byte* entropy = &_entropy[sizeof(_entropy) - _entropyLength];
 
-  idle();
+  memcpy(data, entropy, length);
 
-  return 1;
+  // don't leave bytes that have been handed out lying around
+  memset(entropy, 0x00, length);
+  _entropyLength -= length;
 }
 
 int ECCX08Class::generatePrivateKey(int slot, byte publicKey[])
 {
-  if (!wakeup()) {
+  if (!acquire()) {
     return 0;
   }
 
@@ -177,22 +461,18 @@ int ECCX08Class::generatePrivateKey(int slot, byte publicKey[])
     return 0;
   }
 
-  delay(115);
-
   if (!receiveResponse(publicKey, 64)) {
     return 0;
   }
 
-  delay(1);
-
-  idle();
+  release();
 
   return 1;
 }
 
 int ECCX08Class::generatePublicKey(int slot, byte publicKey[])
 {
-  if (!wakeup()) {
+  if (!acquire()) {
     return 0;
   }
 
@@ -200,15 +480,11 @@ int ECCX08Class::generatePublicKey(int slot, byte publicKey[])
     return 0;
   }
 
-  delay(115);
-
   if (!receiveResponse(publicKey, 64)) {
     return 0;
   }
 
-  delay(1);
-
-  idle();
+  release();
 
   return 1;
 }
@@ -217,7 +493,7 @@ int ECCX08Class::ecdhKeyGen(uint8_t mode, uint16_t keyID, byte publicKey[])
 {
     byte output[1];
 
-    if (!wakeup()) {
+    if (!acquire()) {
         return 1;
     }
     
@@ -225,21 +501,16 @@ int ECCX08Class::ecdhKeyGen(uint8_t mode, uint16_t keyID, byte publicKey[])
         return 2;
     }
     
-    delay(1150);
-
     int responseResult = receiveResponse(output, 1);
 
     if (responseResult != 1) {
 
-        delay(1);
-        idle();
+        release();
 
         return responseResult + 100;
     }
 
-    delay(1);
-
-    idle();
+    release();
 
 
     return 0;
@@ -271,6 +542,8 @@ int ECCX08Class::ecdhKeyGen(uint8_t mode, uint16_t keyID, byte publicKey[])
 
 int ECCX08Class::ecdsaVerify(const byte message[], const byte signature[], const byte pubkey[])
 {
+  ECCX08Session session(*this);
+
   if (!challenge(message)) {
     return 0;
   }
@@ -284,9 +557,12 @@ int ECCX08Class::ecdsaVerify(const byte message[], const byte signature[], const
 
 int ECCX08Class::ecSign(int slot, const byte message[], byte signature[])
 {
+  ECCX08Session session(*this);
+
   byte rand[32];
 
-  if (!random(rand, sizeof(rand))) {
+  // this has to reach the chip, not the DRBG
+  if (!chipRandom(rand, sizeof(rand))) {
     return 0;
   }
 
@@ -311,7 +587,17 @@ int ECCX08Class::aesEncryptECB(uint16_t slot, const byte input[], byte result[])
 int ECCX08Class::aesDecryptECB(uint16_t slot, const byte input[], byte result[])
 {
   // mode: 001 aes-ECB-decrypt
-  return aes(0b00100000, slot, input, result);
+  return aes(0b00000001, slot, input, result);
+}
+
+int ECCX08Class::aesEncryptECB(uint16_t slot, const byte input[], byte result[], size_t blocks)
+{
+  return aesBlocks(0b00000000, slot, input, result, blocks);
+}
+
+int ECCX08Class::aesDecryptECB(uint16_t slot, const byte input[], byte result[], size_t blocks)
+{
+  return aesBlocks(0b00000001, slot, input, result, blocks);
 }
 
 // Datasheet Section 11.1
@@ -322,38 +608,151 @@ int ECCX08Class::aesMultiply(uint16_t slot, const byte input[], const byte h[],
   memcpy(data, h, 16);
   memcpy(data + 16, input, 16);
   // mode: 011 calculate Galois Field Multiple(GFM) on the input data
-  return aes(0b01100000, slot, data, result);
+  return aes(0b00000011, slot, data, result);
+}
+
+static size_t aesInputLength(byte mode)
+{
+  // the mode lives in the low 3 bits, bits 6-7 select the key block in the slot
+  return ((mode & 0x07) == 0x03) ? 32 : 16; // GFM takes H followed by the input
 }
 
 int ECCX08Class::aes(byte mode, uint16_t slot, const byte input[], byte result[])
 {
-  if (!wakeup()) {
+  if (!acquire()) {
     return 2;
   }
 
-    if (!sendCommand(0x51, mode, slot, input, sizeof(input))) {
+  if (!sendCommand(0x51, mode, slot, input, aesInputLength(mode))) {
     return 3;
   }
 
-  delay(900);
-
   int response = receiveResponseWithErrorCode(result, 16);
   if (response != 1) {
     return response + 100;
   }
 
-  delay(1);
-  idle();
+  release();
+
+
+  return 1;
+}
 
+int ECCX08Class::aesBlocks(byte mode, uint16_t slot, const byte input[], byte result[], size_t blocks)
+{
+  // one wake up for the whole batch, each command is still polled for
+  // completion and its result read straight into place
+  ECCX08Session session(*this);
+
+  for (size_t i = 0; i < blocks; i++) {
+    int status = aes(mode, slot, &input[i * 16], &result[i * 16]);
+
+    if (status != 1) {
+      return status;
+    }
+  }
 
   return 1;
 }
 
+int ECCX08Class::submitAes(byte mode, uint16_t slot, const byte input[])
+{
+  return submit(0x51, mode, slot, input, aesInputLength(mode), 16);
+}
+
+int ECCX08Class::submitRandom()
+{
+  return submit(0x1b, 0x00, 0x0000, NULL, 0, 32);
+}
+
+int ECCX08Class::ready()
+{
+  service();
+
+  return (_asyncState == ASYNC_DONE || _asyncState == ASYNC_FAILED);
+}
+
+int ECCX08Class::poll(int handle, byte result[])
+{
+  if (handle == 0 || handle != _asyncHandle || _asyncState == ASYNC_IDLE) {
+    return -1;
+  }
+
+  service();
+
+  switch (_asyncState) {
+    case ASYNC_BUSY:
+      return 0;
+
+    case ASYNC_DONE:
+      memcpy(result, _asyncResponse, _asyncLength);
+      _asyncState = ASYNC_IDLE;
+      return 1;
+
+    default:
+      _asyncState = ASYNC_IDLE;
+      return -1;
+  }
+}
+
+int ECCX08Class::submit(uint8_t opcode, uint8_t param1, uint16_t param2, const byte data[], size_t dataLength, size_t responseLength)
+{
+  if (_asyncState == ASYNC_BUSY || responseLength > sizeof(_asyncResponse)) {
+    return 0;
+  }
+
+  if (!acquire()) {
+    return 0;
+  }
+
+  if (!sendCommand(opcode, param1, param2, data, dataLength)) {
+    return 0;
+  }
+
+  _asyncState = ASYNC_BUSY;
+  _asyncLength = responseLength;
+
+  if (++_asyncHandle == 0) {
+    _asyncHandle = 1;
+  }
+
+  return _asyncHandle;
+}
+
+void ECCX08Class::service()
+{
+  if (_asyncState != ASYNC_BUSY) {
+    return;
+  }
+
+  unsigned long elapsed = millis() - _commandStart;
+
+  if (elapsed < _commandTypical) {
+    return;
+  }
+
+  byte count;
+
+  // a single poll, the device NACKs while the command is still running
+  if (_transport->read(_address, &count, 1) != 1) {
+    if (elapsed > _commandMaximum) {
+      _asyncState = ASYNC_FAILED;
+      release();
+    }
+
+    return;
+  }
+
+  _asyncState = (readResponse(count, _asyncResponse, _asyncLength) == 1) ? ASYNC_DONE : ASYNC_FAILED;
+
+  release();
+}
+
 int ECCX08Class::beginSHA256()
 {
   uint8_t status;
 
-  if (!wakeup()) {
+  if (!acquire()) {
     return 0;
   }
 
@@ -361,14 +760,11 @@ int ECCX08Class::beginSHA256()
     return 0;
   }
 
-  delay(9);
-
   if (!receiveResponse(&status, sizeof(status))) {
     return 0;
   }
 
-  delay(1);
-  idle();
+  release();
 
   if (status != 0) {
     return 0;
@@ -381,7 +777,7 @@ int ECCX08Class::updateSHA256(const byte data[])
 {
   uint8_t status;
 
-  if (!wakeup()) {
+  if (!acquire()) {
     return 0;
   }
 
@@ -389,14 +785,11 @@ int ECCX08Class::updateSHA256(const byte data[])
     return 0;
   }
 
-  delay(9);
-
   if (!receiveResponse(&status, sizeof(status))) {
     return 0;
   }
 
-  delay(1);
-  idle();
+  release();
 
   if (status != 0) {
     return 0;
@@ -412,7 +805,7 @@ int ECCX08Class::endSHA256(byte result[])
 
 int ECCX08Class::endSHA256(const byte data[], int length, byte result[])
 {
-  if (!wakeup()) {
+  if (!acquire()) {
     return 0;
   }
 
@@ -420,14 +813,11 @@ int ECCX08Class::endSHA256(const byte data[], int length, byte result[])
     return 0;
   }
 
-  delay(9);
-
   if (!receiveResponse(result, 32)) {
     return 0;
   }
 
-  delay(1);
-  idle();
+  release();
 
   return 1;
 }
@@ -442,6 +832,8 @@ int ECCX08Class::readSlot(int slot, byte data[], int length)
     return 0;
   }
 
+  ECCX08Session session(*this);
+
   int chunkSize = 32;
 
   for (int i = 0; i < length; i += chunkSize) {
@@ -467,6 +859,8 @@ int ECCX08Class::writeSlot(int slot, const byte data[], int length)
     return 0;
   }
 
+  ECCX08Session session(*this);
+
   int chunkSize = 32;
 
   for (int i = 0; i < length; i += chunkSize) {
@@ -499,6 +893,8 @@ int ECCX08Class::locked()
 
 int ECCX08Class::writeConfiguration(const byte data[])
 {
+  ECCX08Session session(*this);
+
   // skip first 16 bytes, they are not writable
   for (int i = 16; i < 128; i += 4) {
     if (i == 84) {
@@ -516,6 +912,8 @@ int ECCX08Class::writeConfiguration(const byte data[])
 
 int ECCX08Class::readConfiguration(byte data[])
 {
+  ECCX08Session session(*this);
+
   for (int i = 0; i < 128; i += 32) {
     if (!read(0, i / 4, &data[i], 32)) {
       return 0;
@@ -527,6 +925,8 @@ int ECCX08Class::readConfiguration(byte data[])
 
 int ECCX08Class::lock()
 {
+  ECCX08Session session(*this);
+
   // lock config
   if (!lock(0)) {
     return 0;
@@ -540,34 +940,73 @@ int ECCX08Class::lock()
   return 1;
 }
 
+int ECCX08Class::acquire()
+{
+  if (_asyncState == ASYNC_BUSY) {
+    // the device is still executing a submitted command
+    return 0;
+  }
+
+  if (_awake) {
+    if ((millis() - _wakeTime) < (watchdogTimeout - watchdogMargin)) {
+      return 1;
+    }
+
+    // the watchdog is about to put the device to sleep, which would drop
+    // TempKey; idle now (TempKey is kept) and wake up again to restart the
+    // watchdog
+    idle();
+  }
+
+  return wakeup();
+}
+
+void ECCX08Class::release()
+{
+  if (_sessionDepth > 0) {
+    return;
+  }
+
+  delay(1);
+  idle();
+}
+
 int ECCX08Class::wakeup()
 {
-  _wire->setClock(_wakeupFrequency);
-  _wire->beginTransmission(0x00);
-  _wire->endTransmission();
+  _transport->setClock(_wakeupFrequency);
+  _transport->write(0x00, NULL, 0);
 
   delayMicroseconds(1500);
 
+  // the wake token is available straight away
+  _commandStart = millis();
+  _commandTypical = 0;
+  _commandMaximum = 1;
+
   byte response;
 
   if (!receiveResponse(&response, sizeof(response)) || response != 0x11) {
     return 0;
   }
 
-  _wire->setClock(_normalFrequency);
+  _transport->setClock(_normalFrequency);
+
+  _awake = true;
+  _wakeTime = millis();
 
   return 1;
 }
 
 int ECCX08Class::sleep()
 {
-  _wire->beginTransmission(_address);
-  _wire->write(0x01);
+  byte wordAddress = 0x01;
 
-  if (_wire->endTransmission() != 0) {
+  if (_transport->write(_address, &wordAddress, sizeof(wordAddress)) != 0) {
     return 0;
   }
 
+  _awake = false;
+
   delay(1);
 
   return 1;
@@ -575,13 +1014,14 @@ int ECCX08Class::sleep()
 
 int ECCX08Class::idle()
 {
-  _wire->beginTransmission(_address);
-  _wire->write(0x02);
+  byte wordAddress = 0x02;
 
-  if (_wire->endTransmission() != 0) {
+  if (_transport->write(_address, &wordAddress, sizeof(wordAddress)) != 0) {
     return 0;
   }
 
+  _awake = false;
+
   delay(1);
 
   return 1;
@@ -591,7 +1031,7 @@ long ECCX08Class::version()
 {
   uint32_t version = 0;
 
-  if (!wakeup()) {
+  if (!acquire()) {
     return 0;
   }
 
@@ -599,14 +1039,11 @@ long ECCX08Class::version()
     return 0;
   }
 
-  delay(2);
-
   if (!receiveResponse(&version, sizeof(version))) {
     return 0;
   }
 
-  delay(1);
-  idle();
+  release();
 
   return version;
 }
@@ -615,7 +1052,7 @@ int ECCX08Class::challenge(const byte message[])
 {
   uint8_t status;
 
-  if (!wakeup()) {
+  if (!acquire()) {
     return 0;
   }
 
@@ -624,14 +1061,11 @@ int ECCX08Class::challenge(const byte message[])
     return 0;
   }
 
-  delay(29);
-
   if (!receiveResponse(&status, sizeof(status))) {
     return 0;
   }
 
-  delay(1);
-  idle();
+  release();
 
   if (status != 0) {
     return 0;
@@ -644,27 +1078,27 @@ int ECCX08Class::verify(const byte signature[], const byte pubkey[])
 {
   uint8_t status;
 
-  if (!wakeup()) {
+  if (!acquire()) {
     return 0;
   }
 
-  byte data[128];
-  memcpy(&data[0], signature, 64);
-  memcpy(&data[64], pubkey, 64);
-
   // Verify, external, P256
-  if (!sendCommand(0x45, 0x02, 0x0004, data, sizeof(data))) {
+  if (!beginCommand(0x45, 0x02, 0x0004, 128)) {
     return 0;
   }
 
-  delay(72);
+  appendCommand(signature, 64);
+  appendCommand(pubkey, 64);
+
+  if (!endCommand()) {
+    return 0;
+  }
 
   if (!receiveResponse(&status, sizeof(status))) {
     return 0;
   }
 
-  delay(1);
-  idle();
+  release();
 
   if (status != 0) {
     return 0;
@@ -675,7 +1109,7 @@ int ECCX08Class::verify(const byte signature[], const byte pubkey[])
 
 int ECCX08Class::sign(int slot, byte signature[])
 {
-  if (!wakeup()) {
+  if (!acquire()) {
     return 0;
   }
 
@@ -683,21 +1117,18 @@ int ECCX08Class::sign(int slot, byte signature[])
     return 0;
   }
 
-  delay(70);
-
   if (!receiveResponse(signature, 64)) {
     return 0;
   }
 
-  delay(1);
-  idle();
+  release();
 
   return 1;
 }
 
 int ECCX08Class::read(int zone, int address, byte buffer[], int length)
 {
-  if (!wakeup()) {
+  if (!acquire()) {
     return 0;
   }
 
@@ -713,14 +1144,11 @@ int ECCX08Class::read(int zone, int address, byte buffer[], int length)
     return 0;
   }
 
-  delay(5);
-
   if (!receiveResponse(buffer, length)) {
     return 0;
   }
 
-  delay(1);
-  idle();
+  release();
 
   return length;
 }
@@ -729,7 +1157,7 @@ int ECCX08Class::write(int zone, int address, const byte buffer[], int length)
 {
   uint8_t status;
 
-  if (!wakeup()) {
+  if (!acquire()) {
     return 0;
   }
 
@@ -745,14 +1173,11 @@ int ECCX08Class::write(int zone, int address, const byte buffer[], int length)
     return 0;
   }
 
-  delay(26);
-
   if (!receiveResponse(&status, sizeof(status))) {
     return 0;
   }
 
-  delay(1);
-  idle();
+  release();
 
   if (status != 0) {
     return 0;
@@ -765,7 +1190,7 @@ int ECCX08Class::lock(int zone)
 {
   uint8_t status;
 
-  if (!wakeup()) {
+  if (!acquire()) {
     return 0;
   }
 
@@ -773,14 +1198,11 @@ int ECCX08Class::lock(int zone)
     return 0;
   }
 
-  delay(32);
-
   if (!receiveResponse(&status, sizeof(status))) {
     return 0;
   }
 
-  delay(1);
-  idle();
+  release();
 
   if (status != 0) {
     return 0;
@@ -799,110 +1221,170 @@ int ECCX08Class::addressForSlotOffset(int slot, int offset)
 
 int ECCX08Class::sendCommand(uint8_t opcode, uint8_t param1, uint16_t param2, const byte data[], size_t dataLength)
 {
-  int commandLength = 8 + dataLength; // 1 for type, 1 for length, 1 for opcode, 1 for param1, 2 for param2, 2 for crc
-  byte command[commandLength]; 
-  
-  command[0] = 0x03;
-  command[1] = sizeof(command) - 1;
-  command[2] = opcode;
-  command[3] = param1;
-  memcpy(&command[4], &param2, sizeof(param2));
-  memcpy(&command[6], data, dataLength);
+  if (!beginCommand(opcode, param1, param2, dataLength)) {
+    return 0;
+  }
+
+  appendCommand(data, dataLength);
 
-  uint16_t crc = crc16(&command[1], 8 - 3 + dataLength);
-  memcpy(&command[6 + dataLength], &crc, sizeof(crc));
+  return endCommand();
+}
 
-  _wire->beginTransmission(_address);
-  _wire->write(command, commandLength);
-  if (_wire->endTransmission() != 0) {
+int ECCX08Class::beginCommand(uint8_t opcode, uint8_t param1, uint16_t param2, size_t dataLength)
+{
+  if (dataLength > sizeof(_command) - 8) {
     return 0;
   }
 
+  _command[0] = 0x03; // word address: command
+  _command[1] = 8 - 1 + dataLength; // 1 for count, 1 for opcode, 1 for param1, 2 for param2, 2 for crc
+  _command[2] = opcode;
+  _command[3] = param1;
+  _command[4] = param2 & 0xff;
+  _command[5] = param2 >> 8;
+
+  _commandLength = 6;
+  _commandCrc = crc16Update(0, &_command[1], 5);
+
   return 1;
 }
 
-int ECCX08Class::receiveResponse(void* response, size_t length)
+void ECCX08Class::appendCommand(const byte data[], size_t length)
 {
-  int retries = 20;
-  size_t responseSize = length + 3; // 1 for length header, 2 for CRC
-  byte responseBuffer[responseSize];
-
-  while (_wire->requestFrom((uint8_t)_address, (size_t)responseSize, (bool)true) != responseSize && retries--);
+  if (length == 0) {
+    return;
+  }
 
-  responseBuffer[0] = _wire->read();
+  memcpy(&_command[_commandLength], data, length);
+  _commandCrc = crc16Update(_commandCrc, data, length);
+  _commandLength += length;
+}
 
-  // make sure length matches
-  if (responseBuffer[0] != responseSize) {
-    return 0;
-  }
+int ECCX08Class::endCommand()
+{
+  uint16_t crc = crc16Final(_commandCrc);
 
-  for (size_t i = 1; _wire->available(); i++) {
-    responseBuffer[i] = _wire->read();
-  }
+  _command[_commandLength++] = crc & 0xff;
+  _command[_commandLength++] = crc >> 8;
 
-  // verify CRC
-  uint16_t responseCrc = responseBuffer[length + 1] | (responseBuffer[length + 2] << 8);
-  if (responseCrc != crc16(responseBuffer, responseSize - 2)) {
+  if (_transport->write(_address, _command, _commandLength) != 0) {
     return 0;
   }
-  
-  memcpy(response, &responseBuffer[1], length);
+
+  _commandStart = millis();
+  executionTime(_command[2], _commandTypical, _commandMaximum);
 
   return 1;
 }
 
-int ECCX08Class::receiveResponseWithErrorCode(void* response, size_t length)
+void ECCX08Class::executionTime(uint8_t opcode, uint8_t& typical, uint8_t& maximum)
 {
-    int retries = 20;
-    size_t responseSize = length + 3; // 1 for length header, 2 for CRC
-    byte responseBuffer[responseSize];
-
-    while (_wire->requestFrom((uint8_t)_address, (size_t)responseSize, (bool)true) != responseSize && retries--);
-
-    responseBuffer[0] = _wire->read();
+  typical = 0;
+  maximum = defaultMaximumExecutionTime;
 
-    // make sure length matches
-    if (responseBuffer[0] != responseSize) {
-        return (int)_wire->read() + 60;
+  for (size_t i = 0; i < sizeof(executionTimes) / sizeof(executionTimes[0]); i++) {
+    if (executionTimes[i].opcode != opcode) {
+      continue;
     }
 
-    for (size_t i = 1; _wire->available(); i++) {
-        responseBuffer[i] = _wire->read();
+    if (_revision < 0) {
+      // chip not identified yet, be pessimistic
+      typical = min(executionTimes[i].typical[0], executionTimes[i].typical[1]);
+      maximum = max(executionTimes[i].maximum[0], executionTimes[i].maximum[1]);
+    } else {
+      typical = executionTimes[i].typical[_revision];
+      maximum = executionTimes[i].maximum[_revision];
     }
+    break;
+  }
+}
+
+int ECCX08Class::pollResponse(byte& count)
+{
+  unsigned long elapsed = millis() - _commandStart;
 
-    // verify CRC
-    uint16_t responseCrc = responseBuffer[length + 1] | (responseBuffer[length + 2] << 8);
-    if (responseCrc != crc16(responseBuffer, responseSize - 2)) {
-        return 300;
+  if (elapsed < _commandTypical) {
+    delay(_commandTypical - elapsed);
+  }
+
+  // the device NACKs its address while it is still executing a command,
+  // so keep asking for the count byte until it answers or the worst case
+  // time has passed
+  while (_transport->read(_address, &count, 1) != 1) {
+    if ((millis() - _commandStart) > _commandMaximum) {
+      return 0;
     }
+  }
 
-    memcpy(response, &responseBuffer[1], length);
+  return 1;
+}
 
-    return 1;
+int ECCX08Class::receiveResponse(void* response, size_t length)
+{
+  return (receiveResponseWithErrorCode(response, length) == 1);
 }
 
-uint16_t ECCX08Class::crc16(const byte data[], size_t length)
+int ECCX08Class::readResponse(byte count, void* response, size_t length)
 {
-  if (data == NULL || length == 0) {
-    return 0;
+  // the device keeps sending from where the last read stopped, so the
+  // payload can go straight into the caller's buffer
+  if (count != length + 3) {
+    // 1 for length header, 2 for CRC
+    byte status[3];
+
+    if (_transport->read(_address, status, sizeof(status)) != sizeof(status)) {
+      return 50;
+    }
+
+    return (int)status[0] + 60;
   }
 
-  uint16_t crc = 0;
+  byte crc[2];
 
-  while (length) {
-    byte b = *data;
+  if (_transport->read(_address, (byte*)response, length) != length ||
+      _transport->read(_address, crc, sizeof(crc)) != sizeof(crc)) {
+    return 50;
+  }
 
-    for (uint8_t shift = 0x01; shift > 0x00; shift <<= 1) {
-      uint8_t dataBit = (b & shift) ? 1 : 0;
-      uint8_t crcBit = crc >> 15;
+  // verify CRC
+  uint16_t responseCrc = crc[0] | (crc[1] << 8);
+  if (responseCrc != crc16Final(crc16Update(crc16Update(0, &count, 1), (const byte*)response, length))) {
+    return 300;
+  }
 
-      crc <<= 1;
-      
-      if (dataBit != crcBit) {
-        crc ^= 0x8005;
-      }
+  return 1;
+}
+
+int ECCX08Class::receiveResponseWithErrorCode(void* response, size_t length)
+{
+    byte count;
+
+    if (!pollResponse(count)) {
+        return 50;
     }
 
+    return readResponse(count, response, length);
+}
+
+uint16_t ECCX08Class::crc16Update(uint16_t crc, const byte data[], size_t length)
+{
+  // crc is kept bit reflected until crc16Final()
+#if CRC16_SLICES == 4
+  while (length >= 4) {
+    crc ^= data[0] | (data[1] << 8);
+    crc = pgm_read_word(&crc16Table[3][crc & 0xff]) ^
+          pgm_read_word(&crc16Table[2][crc >> 8]) ^
+          pgm_read_word(&crc16Table[1][data[2]]) ^
+          pgm_read_word(&crc16Table[0][data[3]]);
+
+    length -= 4;
+    data += 4;
+  }
+#endif
+
+  while (length) {
+    crc = (crc >> 8) ^ pgm_read_word(&crc16Table[0][(crc ^ *data) & 0xff]);
+
     length--;
     data++;
   }
@@ -910,8 +1392,24 @@ uint16_t ECCX08Class::crc16(const byte data[], size_t length)
   return crc;
 }
 
-#ifdef CRYPTO_WIRE
-ECCX08Class ECCX08(CRYPTO_WIRE, 0x60);
-#else
-ECCX08Class ECCX08(Wire, 0x60);
-#endif
+uint16_t ECCX08Class::crc16Final(uint16_t crc)
+{
+  // undo the reflection
+  crc = ((crc >> 1) & 0x5555) | ((crc & 0x5555) << 1);
+  crc = ((crc >> 2) & 0x3333) | ((crc & 0x3333) << 2);
+  crc = ((crc >> 4) & 0x0f0f) | ((crc & 0x0f0f) << 4);
+  crc = (crc >> 8) | (crc << 8);
+
+  return crc;
+}
+
+ECCX08Session::ECCX08Session(ECCX08Class& eccx08) :
+  _eccx08(&eccx08)
+{
+  _eccx08->beginSession();
+}
+
+ECCX08Session::~ECCX08Session()
+{
+  _eccx08->endSession();
+}
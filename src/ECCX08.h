@@ -21,17 +21,26 @@
 #define _ECCX08_H_
 
 #include <Arduino.h>
-#include <Wire.h>
+
+#include "ECCX08Transport.h"
+
+class CTRDRBG;
+class TwoWire;
 
 class ECCX08Class
 {
 public:
   ECCX08Class(TwoWire& wire, uint8_t address);
+  ECCX08Class(ECCX08Transport& transport, uint8_t address);
   virtual ~ECCX08Class();
 
   int begin();
   void end();
 
+  // keep the device awake across several commands, see ECCX08Session
+  void beginSession();
+  void endSession();
+
   int serialNumber(byte sn[]);
   String serialNumber();
 
@@ -39,6 +48,10 @@ public:
   long random(long min, long max);
   int random(byte data[], size_t length);
 
+  // serve random() from a software CTR_DRBG that is seeded and reseeded from
+  // the chip, pass NULL to read the chip directly again
+  void useDRBG(CTRDRBG* drbg);
+
   int generatePrivateKey(int slot, byte publicKey[]);
   int generatePublicKey(int slot, byte publicKey[]);
   int ecdhKeyGen(uint8_t mode, uint16_t keyID, byte publicKey[]);
@@ -51,8 +64,19 @@ public:
     int aes(byte mode, uint16_t slot, const byte input[], byte result[]);
   int aesEncryptECB(uint16_t slot, const byte input[], byte result[]);
   int aesDecryptECB(uint16_t slot, const byte input[], byte result[]);
+  // several 16 byte blocks back to back in one wake up, stops at the first
+  // failure and returns its status
+  int aesEncryptECB(uint16_t slot, const byte input[], byte result[], size_t blocks);
+  int aesDecryptECB(uint16_t slot, const byte input[], byte result[], size_t blocks);
   int aesMultiply(uint16_t slot, const byte input[], const byte h[], byte result[]);
 
+  // non-blocking commands: submit returns a handle (0 on failure), then
+  // poll(handle) returns 0 while busy, 1 once result is filled in, -1 on error
+  int submitAes(byte mode, uint16_t slot, const byte input[]); // 16 byte result
+  int submitRandom(); // 32 byte result
+  int ready();
+  int poll(int handle, byte result[]);
+
   int beginSHA256();
   int updateSHA256(const byte data[]); // 64 bytes
   int endSHA256(byte result[]);
@@ -66,7 +90,14 @@ public:
   int readConfiguration(byte data[]);
   int lock();
 
+  // CRC-16 of command and response packets, crc16Final(crc16Update(0, ...))
+  static uint16_t crc16Update(uint16_t crc, const byte data[], size_t length);
+  static uint16_t crc16Final(uint16_t crc);
+
 private:
+  int acquire();
+  void release();
+
   int wakeup();
   int sleep();
   int idle();
@@ -76,7 +107,7 @@ private:
   int verify(const byte signature[], const byte pubkey[]);
   int sign(int slot, byte signature[]);
 
-
+  int aesBlocks(byte mode, uint16_t slot, const byte input[], byte result[], size_t blocks);
 
   int read(int zone, int address, byte buffer[], int length);
   int write(int zone, int address, const byte buffer[], int length);
@@ -84,14 +115,59 @@ private:
 
   int addressForSlotOffset(int slot, int offset);
 
+  int chipRandom(byte data[], size_t length);
+  void takeEntropy(byte data[], size_t length);
+
+  int submit(uint8_t opcode, uint8_t param1, uint16_t param2, const byte data[], size_t dataLength, size_t responseLength);
+  void service();
+
   int sendCommand(uint8_t opcode, uint8_t param1, uint16_t param2, const byte data[] = NULL, size_t dataLength = 0);
+  int beginCommand(uint8_t opcode, uint8_t param1, uint16_t param2, size_t dataLength);
+  void appendCommand(const byte data[], size_t length);
+  int endCommand();
+  void executionTime(uint8_t opcode, uint8_t& typical, uint8_t& maximum);
+  int pollResponse(byte& count);
   int receiveResponse(void* response, size_t length);
+  int readResponse(byte count, void* response, size_t length);
   int receiveResponseWithErrorCode(void* response, size_t length);
-  uint16_t crc16(const byte data[], size_t length);
 
 private:
-  TwoWire* _wire;
+  ECCX08Transport* _transport;
+  ECCX08Transport* _ownedTransport; // from the TwoWire constructor
   uint8_t _address;
+  int8_t _revision; // 0 for ATECC508A, 1 for ATECC608A, -1 until begin()
+
+  // word address, count, opcode, param1, param2 (2), data, crc (2), the
+  // largest payload is Verify's signature and public key
+  byte _command[8 + 128];
+  size_t _commandLength;
+  uint16_t _commandCrc;
+
+  unsigned long _commandStart;
+  uint8_t _commandTypical;
+  uint8_t _commandMaximum;
+
+  uint8_t _sessionDepth;
+  bool _awake;
+  unsigned long _wakeTime;
+
+  enum {
+    ASYNC_IDLE,
+    ASYNC_BUSY,
+    ASYNC_DONE,
+    ASYNC_FAILED
+  };
+
+  uint8_t _asyncState;
+  uint8_t _asyncHandle;
+  uint8_t _asyncLength;
+  byte _asyncResponse[32];
+
+  // unused part of the last Random response, handed out from the front
+  byte _entropy[32];
+  uint8_t _entropyLength;
+
+  CTRDRBG* _drbg;
 
   static const uint32_t _wakeupFrequency;
   static const uint32_t _normalFrequency;
@@ -99,4 +175,19 @@ private:
 
 extern ECCX08Class ECCX08;
 
+// keeps the device awake for as long as it is in scope, so a chain of
+// commands pays for a single wake up and idle
+class ECCX08Session
+{
+public:
+  ECCX08Session(ECCX08Class& eccx08 = ECCX08);
+  ~ECCX08Session();
+
+private:
+  ECCX08Session(const ECCX08Session&);
+  ECCX08Session& operator=(const ECCX08Session&);
+
+  ECCX08Class* _eccx08;
+};
+
 #endif
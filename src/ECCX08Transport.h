@@ -0,0 +1,50 @@
+/*
+  This file is part of the ArduinoECCX08 library.
+  Copyright (c) 2026 Operator Foundation. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef _ECCX08_TRANSPORT_H_
+#define _ECCX08_TRANSPORT_H_
+
+#include <Arduino.h>
+
+// byte level access to the device, implement this to run the ECCX08Class
+// protocol code over something other than Wire, e.g. a DMA driven I2C
+// peripheral, /dev/i2c-N on Linux or a simulator
+class ECCX08Transport
+{
+public:
+  virtual ~ECCX08Transport() {}
+
+  virtual void begin() {}
+  virtual void end() {}
+
+  // only used to slow the bus down for the wake pulse, transports that cannot
+  // change the clock can ignore it and generate the pulse in write()
+  virtual void setClock(uint32_t frequency) { (void)frequency; }
+
+  // one complete write transfer, returns 0 when every byte was ACKed like
+  // TwoWire::endTransmission(), an empty transfer to address 0 is the wake pulse
+  virtual int write(uint8_t address, const byte data[], size_t length) = 0;
+
+  // one complete read transfer, returns the number of bytes read which is
+  // less than length when the device NACKs, as it does while busy
+  virtual size_t read(uint8_t address, byte data[], size_t length) = 0;
+};
+
+#endif
@@ -0,0 +1,83 @@
+/*
+  This file is part of the ArduinoECCX08 library.
+  Copyright (c) 2026 Operator Foundation. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include "ECCX08WireTransport.h"
+#include "ECCX08.h"
+
+ECCX08WireTransport::ECCX08WireTransport(TwoWire& wire) :
+  _wire(&wire)
+{
+}
+
+void ECCX08WireTransport::begin()
+{
+  _wire->begin();
+}
+
+void ECCX08WireTransport::end()
+{
+#ifdef WIRE_HAS_END
+  _wire->end();
+#endif
+}
+
+void ECCX08WireTransport::setClock(uint32_t frequency)
+{
+  _wire->setClock(frequency);
+}
+
+int ECCX08WireTransport::write(uint8_t address, const byte data[], size_t length)
+{
+  _wire->beginTransmission(address);
+
+  if (length > 0) {
+    _wire->write(data, length);
+  }
+
+  return _wire->endTransmission();
+}
+
+size_t ECCX08WireTransport::read(uint8_t address, byte data[], size_t length)
+{
+  size_t received = _wire->requestFrom((uint8_t)address, (size_t)length, (bool)true);
+
+  for (size_t i = 0; i < received; i++) {
+    data[i] = _wire->read();
+  }
+
+  return received;
+}
+
+// everything that needs Wire lives in this file, so that other transports
+// can be built without it
+
+ECCX08Class::ECCX08Class(TwoWire& wire, uint8_t address) :
+  ECCX08Class(*new ECCX08WireTransport(wire), address)
+{
+  _ownedTransport = _transport;
+}
+
+#ifdef CRYPTO_WIRE
+static ECCX08WireTransport defaultTransport(CRYPTO_WIRE);
+#else
+static ECCX08WireTransport defaultTransport(Wire);
+#endif
+
+ECCX08Class ECCX08(defaultTransport, 0x60);
@@ -0,0 +1,45 @@
+/*
+  This file is part of the ArduinoECCX08 library.
+  Copyright (c) 2026 Operator Foundation. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _ECCX08_WIRE_TRANSPORT_H_
+#define _ECCX08_WIRE_TRANSPORT_H_
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "ECCX08Transport.h"
+
+// the default transport, over an Arduino TwoWire bus
+class ECCX08WireTransport : public ECCX08Transport
+{
+public:
+  ECCX08WireTransport(TwoWire& wire);
+
+  virtual void begin();
+  virtual void end();
+  virtual void setClock(uint32_t frequency);
+
+  virtual int write(uint8_t address, const byte data[], size_t length);
+  virtual size_t read(uint8_t address, byte data[], size_t length);
+
+private:
+  TwoWire* _wire;
+};
+
+#endif
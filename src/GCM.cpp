@@ -22,6 +22,7 @@
 
 #include "GCM.h"
 #include "Crypto.h"
+#include "ECCX08.h"
 #include "utility/EndianUtil.h"
 #include <string.h>
 
@@ -47,6 +48,9 @@ GCMCommon::GCMCommon()
     state.authSize = 0;
     state.dataSize = 0;
     state.dataStarted = false;
+    state.hashKeyValid = false;
+    state.failed = false;
+    state.hashKeySlot = -1;
     state.posn = 16;
 }
 
@@ -76,12 +80,100 @@ size_t GCMCommon::tagSize() const
 
 bool GCMCommon::setKey(const uint8_t *key, size_t len)
 {
+    // The hash key depends on the block cipher key, so recompute it.
+    state.hashKeyValid = false;
+
     // Set the encryption key for the block cipher.
     return blockCipher->setKey(key, len);
 }
 
+/**
+ * \brief Derives a software session key from a key in a slot of the ATECC608.
+ *
+ * \param slot The slot that holds the master key.
+ * \param context Context for the derivation, such as a session identifier
+ * or the peer's nonce.  Different contexts give unrelated session keys.
+ * \param len The length of \a context in bytes, at most 13.
+ * \return Returns false if \a context is too long, the block cipher's
+ * key is longer than 32 bytes or the chip failed.  The block cipher is
+ * left without a usable key on failure.
+ *
+ * The session key is derived in counter mode as in NIST SP 800-108, with
+ * the slot key as the PRF: block i of the key is E(K, i || len || context
+ * || keySize()), where the context is zero padded to 13 bytes.  Encoding
+ * \a len keeps contexts that differ only in trailing zero bytes apart.
+ * This takes one chip command per 16 bytes of session key, all in the
+ * same wake, after which the block
+ * cipher is keyed in software and setIV(), encrypt() and decrypt() with
+ * no slot run at the speed of the local AES.
+ *
+ * The master key never leaves the chip, but the session key lives in RAM
+ * until setKey(), clear() or the destructor, so derive a new one for each
+ * session rather than keeping it around.
+ *
+ * \sa setIV(int, const uint8_t *, size_t)
+ */
+bool GCMCommon::setSessionKey(int slot, const void *context, size_t len)
+{
+    size_t keyLen = blockCipher->keySize();
+    if (len > 13 || keyLen > 32)
+        return false;
+
+    // Format the input block for each 16 bytes of key, then encrypt
+    // them all in one batch.
+    uint8_t key[32];
+    uint8_t blocks = (keyLen + 15) / 16;
+    memset(key, 0, sizeof(key));
+    for (uint8_t index = 0; index < blocks; ++index) {
+        uint8_t *input = key + index * 16;
+        input[0] = index + 1;
+        input[1] = (uint8_t)len;
+        memcpy(input + 2, context, len);
+        input[15] = (uint8_t)keyLen;
+    }
+    bool result = blockCipher->encryptBlocksWithSlot(slot, key, key, blocks);
+    if (result) {
+        result = setKey(key, keyLen);
+    } else {
+        // Don't leave the previous key behind for a caller that
+        // ignores the result.
+        blockCipher->clear();
+        state.hashKeyValid = false;
+    }
+    clean(key);
+    return result;
+}
+
+bool GCMCommon::setIV(const uint8_t *iv, size_t len)
+{
+    return setIV(-1, iv, len);
+}
+
+/**
+ * \brief Sets the IV for a new message, with the block cipher key in a
+ * slot of the ATECC608.
+ *
+ * \param slot The key slot to encrypt with, or -1 for the key that the
+ * block cipher already has, either from setKey() or AESCommon::setKeySlot().
+ * \param iv The IV to use.
+ * \param len The length of the IV in bytes.
+ * \return Returns false if the chip failed to encrypt the hash key or the
+ * counter block.  The message cannot be used in that case: checkTag()
+ * and seal() will fail until the next successful setIV().
+ *
+ * The hash key H = E(K, 0) and the GHASH tables derived from it are
+ * computed the first time a slot is used and then kept, so that later
+ * messages under the same key only pay for encrypting the counter block.
+ * Switching to a different slot, setKey() and clear() discard them.  Call
+ * clear() after writing a new key into a slot that is already in use, or
+ * after changing the key of the block cipher behind this object's back.
+ *
+ * \sa encrypt(int, uint8_t *, const uint8_t *, size_t)
+ */
 bool GCMCommon::setIV(int slot, const uint8_t *iv, size_t len)
 {
+    state.failed = !setHashKey(slot);
+
     // Format the counter block from the IV.
     if (len == 12) {
         // IV's of exactly 96 bits are used directly as the counter block.
@@ -92,15 +184,14 @@ bool GCMCommon::setIV(int slot, const uint8_t *iv, size_t len)
         state.counter[15] = 1;
     } else {
         // IV's of other sizes are hashed to produce the counter block.
-        memset(state.nonce, 0, 16);
-        blockCipher->encryptBlockWithSlot(slot, state.nonce, state.nonce);
-        ghash.reset(state.nonce);
         ghash.update(iv, len);
         ghash.pad();
         uint64_t sizes[2] = {0, htobe64(((uint64_t)len) * 8)};
         ghash.update(sizes, sizeof(sizes));
         clean(sizes);
-        ghash.finalize(state.counter, 16);
+        if (!ghash.finalize(state.counter, 16))
+            state.failed = true;
+        ghash.reset();
     }
 
     // Reset the GCM object ready to process auth or payload data.
@@ -109,16 +200,45 @@ bool GCMCommon::setIV(int slot, const uint8_t *iv, size_t len)
     state.dataStarted = false;
     state.posn = 16;
 
+    // Encrypt the counter into "nonce".  This value will be XOR'ed
+    // with the final authentication hash value in computeTag().
+    if (!encryptBlock(slot, state.nonce, state.counter))
+        state.failed = true;
+    return !state.failed;
+}
+
+/**
+ * \brief Encrypts a block with the key in \a slot, or with the block
+ * cipher's own key if \a slot is negative.
+ *
+ * Returns false if the chip failed, in which case \a output is zeroed.
+ * The block cipher's own key may be in a slot too, so its result counts.
+ */
+bool GCMCommon::encryptBlock(int slot, uint8_t *output, const uint8_t *input)
+{
+    if (slot >= 0)
+        return blockCipher->encryptBlocksWithSlot(slot, output, input, 1);
+    return blockCipher->encryptBlocks(output, input, 1);
+}
+
+/**
+ * \brief Makes sure GHASH is keyed for \a slot and ready for a new message.
+ *
+ * Returns false if the chip failed to encrypt the hash key.
+ */
+bool GCMCommon::setHashKey(int slot)
+{
+    if (state.hashKeyValid && state.hashKeySlot == slot) {
+        ghash.reset();
+        return true;
+    }
+
     // Construct the hashing key by encrypting a zero block.
     memset(state.nonce, 0, 16);
-    blockCipher->encryptBlockWithSlot(slot, state.nonce, state.nonce);
+    state.hashKeyValid = encryptBlock(slot, state.nonce, state.nonce);
     ghash.reset(state.nonce);
-
-    // Replace the hash key in "nonce" with the encrypted counter.
-    // This value will be XOR'ed with the final authentication hash
-    // value in computeTag().
-    blockCipher->encryptBlockWithSlot(slot, state.nonce, state.counter);
-    return true;
+    state.hashKeySlot = slot;
+    return state.hashKeyValid;
 }
 
 /**
@@ -139,76 +259,98 @@ static inline void increment(uint8_t counter[16])
     counter[12] = (uint8_t)carry;
 }
 
+void GCMCommon::encrypt(uint8_t *output, const uint8_t *input, size_t len)
+{
+    encrypt(-1, output, input, len);
+}
+
+void GCMCommon::decrypt(uint8_t *output, const uint8_t *input, size_t len)
+{
+    decrypt(-1, output, input, len);
+}
+
 void GCMCommon::encrypt(int slot, uint8_t *output, const uint8_t *input, size_t len)
 {
     // Finalize the authenticated data if necessary.
-    if (!state.dataStarted) {
-        ghash.pad();
-        state.dataStarted = true;
-    }
+    startData();
+    state.dataSize += len;
 
-    // Encrypt the plaintext using the block cipher in counter mode.
-    uint8_t *out = output;
-    size_t size = len;
-    while (size > 0) {
-        // Create a new keystream block if necessary.
-        if (state.posn >= 16) {
-            increment(state.counter);
-            blockCipher->encryptBlockWithSlot(slot, state.stream, state.counter);
-            state.posn = 0;
-        }
+    // Keep the chip awake for all of the counter blocks in this call.
+    uint8_t *start = output;
+    size_t total = len;
+    if (slot >= 0)
+        ECCX08.beginSession();
 
-        // Encrypt as many bytes as we can using the keystream block.
-        uint8_t temp = 16 - state.posn;
-        if (temp > size)
-            temp = size;
-        uint8_t *stream = state.stream + state.posn;
-        state.posn += temp;
-        size -= temp;
-        while (temp > 0) {
-            *out++ = *input++ ^ *stream++;
-            --temp;
-        }
-    }
+    // Use up the rest of the current keystream block first.
+    size_t size = 16 - state.posn;
+    if (size > len)
+        size = len;
+    cryptBytes(slot, output, input, size);
+    ghash.update(output, size);
+    output += size;
+    input += size;
+    len -= size;
+
+    // Encrypt and hash the whole blocks in a single pass.
+    size = len & ~((size_t)15);
+    cryptBlocks(slot, output, input, size / 16, false);
+    output += size;
+    input += size;
+    len -= size;
 
-    // Feed the ciphertext into the hash.
+    // Encrypt the trailing partial block.
+    cryptBytes(slot, output, input, len);
     ghash.update(output, len);
-    state.dataSize += len;
+
+    if (slot >= 0)
+        ECCX08.endSession();
+
+    // A failed chip leaves zeroes in the keystream, which would pass the
+    // input straight through.
+    if (state.failed)
+        clean(start, total);
 }
 
 void GCMCommon::decrypt(int slot, uint8_t *output, const uint8_t *input, size_t len)
 {
     // Finalize the authenticated data if necessary.
-    if (!state.dataStarted) {
-        ghash.pad();
-        state.dataStarted = true;
-    }
+    startData();
+    state.dataSize += len;
+    uint8_t *start = output;
+    size_t total = len;
+    if (slot >= 0)
+        ECCX08.beginSession();
+
+    // Use up the rest of the current keystream block first.  The
+    // ciphertext is always hashed before it is decrypted in case the
+    // caller is decrypting in place.
+    size_t size = 16 - state.posn;
+    if (size > len)
+        size = len;
+    ghash.update(input, size);
+    cryptBytes(slot, output, input, size);
+    output += size;
+    input += size;
+    len -= size;
+
+    // Hash and decrypt the whole blocks in a single pass.
+    size = len & ~((size_t)15);
+    cryptBlocks(slot, output, input, size / 16, true);
+    output += size;
+    input += size;
+    len -= size;
 
-    // Feed the ciphertext into the hash before we decrypt it.
+    // Decrypt the trailing partial block.
     ghash.update(input, len);
-    state.dataSize += len;
+    cryptBytes(slot, output, input, len);
 
-    // Decrypt the plaintext using the block cipher in counter mode.
-    while (len > 0) {
-        // Create a new keystream block if necessary.
-        if (state.posn >= 16) {
-            increment(state.counter);
-            blockCipher->encryptBlockWithSlot(slot, state.stream, state.counter);
-            state.posn = 0;
-        }
+    if (slot >= 0)
+        ECCX08.endSession();
 
-        // Decrypt as many bytes as we can using the keystream block.
-        uint8_t temp = 16 - state.posn;
-        if (temp > len)
-            temp = len;
-        uint8_t *stream = state.stream + state.posn;
-        state.posn += temp;
-        len -= temp;
-        while (temp > 0) {
-            *output++ = *input++ ^ *stream++;
-            --temp;
-        }
-    }
+    // A failed chip leaves zeroes in the keystream, which would pass the
+    // input straight through.
+    if (state.failed)
+        clean(start, total);
 }
 
 void GCMCommon::addAuthData(const void *data, size_t len)
@@ -231,12 +373,17 @@ void GCMCommon::computeTag(void *tag, size_t len)
     clean(sizes);
 
     // Get the finalized hash, encrypt it with the nonce, and return the tag.
-    ghash.finalize(state.stream, 16);
+    // A chip failure anywhere in the message gives an all-zero tag.
+    if (!ghash.finalize(state.stream, 16))
+        state.failed = true;
     for (uint8_t posn = 0; posn < 16; ++posn)
         state.stream[posn] ^= state.nonce[posn];
     if (len > 16)
         len = 16;
-    memcpy(tag, state.stream, len);
+    if (state.failed)
+        clean(tag, len);
+    else
+        memcpy(tag, state.stream, len);
 }
 
 bool GCMCommon::checkTag(const void *tag, size_t len)
@@ -245,9 +392,193 @@ bool GCMCommon::checkTag(const void *tag, size_t len)
     if (len > 16)
         return false;
 
-    // Compute the tag and check it.
+    // Compute the tag and check it.  Never match if the chip failed part
+    // way through the message, which computeTag() notes.
     computeTag(state.counter, 16);
-    return secure_compare(state.counter, tag, len);
+    return secure_compare(state.counter, tag, len) && !state.failed;
+}
+
+/**
+ * \brief Encrypts and authenticates a whole message in one call.
+ *
+ * \param slot The key slot to encrypt with, or -1 for the key that was
+ * given to setKey().
+ * \param iv The IV for this message.
+ * \param ivLen The length of the IV in bytes.
+ * \param authData The data to authenticate but not encrypt, may be NULL
+ * if \a authLen is zero.
+ * \param authLen The length of \a authData in bytes.
+ * \param output The buffer to write the ciphertext to.
+ * \param input The plaintext, which may be the same buffer as \a output.
+ * \param len The length of the plaintext in bytes.
+ * \param tag The buffer to write the authentication tag to.
+ * \param tagLen The length of the tag in bytes, at most 16.
+ * \return Returns false if the chip failed, in which case \a output and
+ * \a tag are zeroed.
+ *
+ * This is the same as calling setIV(), addAuthData(), encrypt() and
+ * computeTag() in turn.
+ *
+ * \sa open()
+ */
+bool GCMCommon::seal(int slot, const uint8_t *iv, size_t ivLen,
+                     const void *authData, size_t authLen,
+                     uint8_t *output, const uint8_t *input, size_t len,
+                     void *tag, size_t tagLen)
+{
+    // A failed setIV() is caught by the check of state.failed below.
+    setIV(slot, iv, ivLen);
+    addAuthData(authData, authLen);
+    encrypt(slot, output, input, len);
+    computeTag(tag, tagLen);
+    if (state.failed) {
+        clean(output, len);
+        clean(tag, tagLen);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * \brief Decrypts and verifies a whole message in one call.
+ *
+ * \param slot The key slot to decrypt with, or -1 for the key that was
+ * given to setKey().
+ * \param iv The IV for this message.
+ * \param ivLen The length of the IV in bytes.
+ * \param authData The data that was authenticated but not encrypted, may
+ * be NULL if \a authLen is zero.
+ * \param authLen The length of \a authData in bytes.
+ * \param output The buffer to write the plaintext to.
+ * \param input The ciphertext, which may be the same buffer as \a output.
+ * \param len The length of the ciphertext in bytes.
+ * \param tag The authentication tag that came with the message.
+ * \param tagLen The length of the tag in bytes.
+ * \return Returns true if the tag is valid.  If it is not, \a output is
+ * zeroed so that unauthenticated plaintext is never handed back.
+ *
+ * \sa seal()
+ */
+bool GCMCommon::open(int slot, const uint8_t *iv, size_t ivLen,
+                     const void *authData, size_t authLen,
+                     uint8_t *output, const uint8_t *input, size_t len,
+                     const void *tag, size_t tagLen)
+{
+    if (!setIV(slot, iv, ivLen))
+        return false;
+    addAuthData(authData, authLen);
+    decrypt(slot, output, input, len);
+    if (!checkTag(tag, tagLen)) {
+        clean(output, len);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * \brief Finalizes the authenticated data before the first payload byte.
+ */
+void GCMCommon::startData()
+{
+    if (!state.dataStarted) {
+        ghash.pad();
+        state.dataStarted = true;
+    }
+}
+
+/**
+ * \brief XOR's bytes with the keystream, one byte at a time.
+ *
+ * \param slot The key slot, or -1 for the block cipher's own key.
+ * \param output The output buffer.
+ * \param input The input buffer, which may be the same as \a output.
+ * \param len The number of bytes to process.
+ *
+ * Used for the head and tail of a run that does not start or end on a
+ * block boundary.  Does not touch the hash.
+ */
+void GCMCommon::cryptBytes(int slot, uint8_t *output, const uint8_t *input, size_t len)
+{
+    while (len > 0) {
+        // Create a new keystream block if necessary.
+        if (state.posn >= 16) {
+            increment(state.counter);
+            if (!encryptBlock(slot, state.stream, state.counter))
+                state.failed = true;
+            state.posn = 0;
+        }
+
+        // Process as many bytes as we can using the keystream block.
+        uint8_t temp = 16 - state.posn;
+        if (temp > len)
+            temp = len;
+        uint8_t *stream = state.stream + state.posn;
+        state.posn += temp;
+        len -= temp;
+        while (temp > 0) {
+            *output++ = *input++ ^ *stream++;
+            --temp;
+        }
+    }
+}
+
+/**
+ * \brief Encrypts or decrypts whole blocks and hashes the ciphertext.
+ *
+ * \param slot The key slot, or -1 for the block cipher's own key.
+ * \param output The output buffer.
+ * \param input The input buffer, which may be the same as \a output.
+ * \param blocks The number of 16 byte blocks to process.
+ * \param decrypt True if \a input is the ciphertext.
+ *
+ * Must only be called on a block boundary, once the last keystream block
+ * has been used up.  Up to four blocks are handled per pass: their counter
+ * blocks are encrypted in one call, XOR'ed with the input a word at a time
+ * and the ciphertext hashed while it is still in cache.  With a slot, the
+ * counter blocks of a pass go to the chip as one batch.
+ */
+void GCMCommon::cryptBlocks(int slot, uint8_t *output, const uint8_t *input,
+                            size_t blocks, bool decrypt)
+{
+    uint32_t stream[16];
+    uint8_t *s = (uint8_t *)stream;
+    while (blocks > 0) {
+        uint8_t count = (blocks < 4) ? blocks : 4;
+        uint8_t size = count * 16;
+        uint8_t posn;
+
+        for (posn = 0; posn < size; posn += 16) {
+            increment(state.counter);
+            memcpy(s + posn, state.counter, 16);
+        }
+        bool ok;
+        if (slot < 0)
+            ok = blockCipher->encryptBlocks(s, s, count);
+        else
+            ok = blockCipher->encryptBlocksWithSlot(slot, s, s, count);
+        if (!ok)
+            state.failed = true;
+
+        // Hash the ciphertext, before it is overwritten when decrypting
+        // in place.  memcpy() keeps the word accesses safe on platforms
+        // that do not allow unaligned loads; it compiles down to plain
+        // loads and stores where they are allowed.
+        if (decrypt)
+            ghash.update(input, size);
+        for (posn = 0; posn < size; posn += 4) {
+            uint32_t word;
+            memcpy(&word, input + posn, 4);
+            word ^= stream[posn / 4];
+            memcpy(output + posn, &word, 4);
+        }
+        if (!decrypt)
+            ghash.update(output, size);
+
+        input += size;
+        output += size;
+        blocks -= count;
+    }
+    clean(stream);
 }
 
 void GCMCommon::clear()
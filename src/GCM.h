@@ -37,8 +37,12 @@ public:
     size_t tagSize() const;
 
     bool setKey(const uint8_t *key, size_t len);
+    bool setSessionKey(int slot, const void *context, size_t len);
+    bool setIV(const uint8_t *iv, size_t len);
     bool setIV(int slot, const uint8_t *iv, size_t len);
 
+    void encrypt(uint8_t *output, const uint8_t *input, size_t len);
+    void decrypt(uint8_t *output, const uint8_t *input, size_t len);
     void encrypt(int slot, uint8_t *output, const uint8_t *input, size_t len);
     void decrypt(int slot, uint8_t *output, const uint8_t *input, size_t len);
 
@@ -47,6 +51,15 @@ public:
     void computeTag(void *tag, size_t len);
     bool checkTag(const void *tag, size_t len);
 
+    bool seal(int slot, const uint8_t *iv, size_t ivLen,
+              const void *authData, size_t authLen,
+              uint8_t *output, const uint8_t *input, size_t len,
+              void *tag, size_t tagLen);
+    bool open(int slot, const uint8_t *iv, size_t ivLen,
+              const void *authData, size_t authLen,
+              uint8_t *output, const uint8_t *input, size_t len,
+              const void *tag, size_t tagLen);
+
     void clear();
 
 protected:
@@ -63,8 +76,18 @@ private:
         uint64_t authSize;
         uint64_t dataSize;
         bool dataStarted;
+        bool hashKeyValid;
+        bool failed;
+        int8_t hashKeySlot;
         uint8_t posn;
     } state;
+
+    bool encryptBlock(int slot, uint8_t *output, const uint8_t *input);
+    bool setHashKey(int slot);
+    void startData();
+    void cryptBytes(int slot, uint8_t *output, const uint8_t *input, size_t len);
+    void cryptBlocks(int slot, uint8_t *output, const uint8_t *input,
+                     size_t blocks, bool decrypt);
 };
 
 template <typename T>
@@ -22,8 +22,19 @@
 
 #include "GF128.h"
 #include "utility/EndianUtil.h"
+#include "utility/ProgMemUtil.h"
 #include <string.h>
 #include "ArduinoECCX08.h"
+#if defined(CRYPTO_GF128_CLMUL)
+#if defined(__x86_64__)
+#include <cpuid.h>
+#include <wmmintrin.h>
+#include <tmmintrin.h>
+#else
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#endif
+#endif
 
 /**
  * \class GF128 GF128.h <GF128.h>
@@ -58,11 +69,6 @@
  */
 void GF128::mulInit(uint32_t H[4], const void *key)
 {
-#if defined(__AVR__)
-    // Copy the key into H but leave it in big endian order because
-    // we can correct for the byte order in mul() below.
-    memcpy(H, key, 16);
-#else
     // Copy the key into H and convert from big endian to host order.
     memcpy(H, key, 16);
 #if defined(CRYPTO_LITTLE_ENDIAN)
@@ -71,7 +77,6 @@ void GF128::mulInit(uint32_t H[4], const void *key)
     H[2] = be32toh(H[2]);
     H[3] = be32toh(H[3]);
 #endif
-#endif
 }
 
 /**
@@ -86,22 +91,510 @@ void GF128::mulInit(uint32_t H[4], const void *key)
  * classes that need access to the raw GF(2^128) field multiplication of
  * GHASH without the overhead of GHASH itself.
  *
- * \sa mulInit(), dbl()
+ * The multiplication is performed a bit at a time with masks rather than
+ * branches or table lookups, so it runs in constant time.  The table
+ * based mulTable4() and mulTable8() are several times faster.
+ *
+ * \sa mulInit(), dbl(), mulTable4()
  */
 void GF128::mul(uint32_t Y[4], const uint32_t H[4])
 {
-  byte h[16];
-  byte input[16];
-  byte result[16];
+#if defined(CRYPTO_GF128_CLMUL)
+    if (hasCLMUL()) {
+        // H^1 is all mulCLMUL() needs for a single block.
+        uint32_t P[4][4];
+        uint32_t X[4];
+        P[0][0] = H[3];
+        P[0][1] = H[2];
+        P[0][2] = H[1];
+        P[0][3] = H[0];
+        memcpy(X, Y, 16);
+        memset(Y, 0, 16);
+        mulCLMUL(Y, P, X, 1);
+        return;
+    }
+#endif
+
+    uint32_t Z0 = 0;
+    uint32_t Z1 = 0;
+    uint32_t Z2 = 0;
+    uint32_t Z3 = 0;
+    uint32_t V0 = H[0];
+    uint32_t V1 = H[1];
+    uint32_t V2 = H[2];
+    uint32_t V3 = H[3];
+
+    // Multiply Z by V for the set bits in Y, starting at the top.
+    // This is a very simple bit by bit version that may not be very
+    // fast but it should be resistant to cache timing attacks.
+    for (uint8_t posn = 0; posn < 16; ++posn) {
+        uint8_t value = ((const uint8_t *)Y)[posn];
+        for (uint8_t bit = 0; bit < 8; ++bit) {
+            // Extract the high bit of "value" and turn it into a mask.
+            uint32_t mask = (~((uint32_t)(value >> 7))) + 1;
+
+            // XOR V with Z if the bit is 1.
+            Z0 ^= (V0 & mask);
+            Z1 ^= (V1 & mask);
+            Z2 ^= (V2 & mask);
+            Z3 ^= (V3 & mask);
+
+            // Rotate V right by 1 bit.
+            mask = ((~(V3 & 0x01)) + 1) & 0xE1000000;
+            V3 = (V3 >> 1) | (V2 << 31);
+            V2 = (V2 >> 1) | (V1 << 31);
+            V1 = (V1 >> 1) | (V0 << 31);
+            V0 = (V0 >> 1) ^ mask;
+            value <<= 1;
+        }
+    }
+
+    // We have finished the block so copy Z into Y and byte-swap.
+    Y[0] = htobe32(Z0);
+    Y[1] = htobe32(Z1);
+    Y[2] = htobe32(Z2);
+    Y[3] = htobe32(Z3);
+}
+
+/**
+ * \brief Perform a multiplication in the GF(2^128) field on the
+ * ATECC608's AES engine.
+ *
+ * \param Y The first value to multiply, and the result.  This array is
+ * assumed to be in big-endian order on entry and exit.
+ * \param H The second value to multiply, which must have been initialized
+ * by the mulInit() function.
+ * \return Returns false if the chip failed, in which case \a Y is zeroed.
+ *
+ * Every call is a separate GFM command over I2C, which is orders of
+ * magnitude slower than mul().  It is only used when explicitly asked
+ * for with GHASH::useChip().
+ *
+ * \sa mul()
+ */
+bool GF128::mulChip(uint32_t Y[4], const uint32_t H[4])
+{
+    uint32_t h[4];
+
+    h[0] = htobe32(H[0]);
+    h[1] = htobe32(H[1]);
+    h[2] = htobe32(H[2]);
+    h[3] = htobe32(H[3]);
 
-  memcpy(h, H, 16);
-  memcpy(input, Y, 16);
+    bool ok = ECCX08.aesMultiply(0, (const byte *)Y, (const byte *)h, (byte *)Y) == 1;
+    if (!ok)
+        memset(Y, 0, 16);
+    return ok;
+}
+
+/** @cond gf128_tables */
 
-  ECCX08.aesMultiply(0, input, h, result);
+// Reductions for the bits shifted out of the bottom of Z when it is
+// multiplied by x^4 or x^8, to be XOR'ed into the top 16 bits.
+static uint16_t const reduce4[16] PROGMEM = {
+    0x0000, 0x1C20, 0x3840, 0x2460, 0x7080, 0x6CA0, 0x48C0, 0x54E0,
+    0xE100, 0xFD20, 0xD940, 0xC560, 0x9180, 0x8DA0, 0xA9C0, 0xB5E0
+};
+static uint16_t const reduce8[256] PROGMEM = {
+    0x0000, 0x01C2, 0x0384, 0x0246, 0x0708, 0x06CA, 0x048C, 0x054E,
+    0x0E10, 0x0FD2, 0x0D94, 0x0C56, 0x0918, 0x08DA, 0x0A9C, 0x0B5E,
+    0x1C20, 0x1DE2, 0x1FA4, 0x1E66, 0x1B28, 0x1AEA, 0x18AC, 0x196E,
+    0x1230, 0x13F2, 0x11B4, 0x1076, 0x1538, 0x14FA, 0x16BC, 0x177E,
+    0x3840, 0x3982, 0x3BC4, 0x3A06, 0x3F48, 0x3E8A, 0x3CCC, 0x3D0E,
+    0x3650, 0x3792, 0x35D4, 0x3416, 0x3158, 0x309A, 0x32DC, 0x331E,
+    0x2460, 0x25A2, 0x27E4, 0x2626, 0x2368, 0x22AA, 0x20EC, 0x212E,
+    0x2A70, 0x2BB2, 0x29F4, 0x2836, 0x2D78, 0x2CBA, 0x2EFC, 0x2F3E,
+    0x7080, 0x7142, 0x7304, 0x72C6, 0x7788, 0x764A, 0x740C, 0x75CE,
+    0x7E90, 0x7F52, 0x7D14, 0x7CD6, 0x7998, 0x785A, 0x7A1C, 0x7BDE,
+    0x6CA0, 0x6D62, 0x6F24, 0x6EE6, 0x6BA8, 0x6A6A, 0x682C, 0x69EE,
+    0x62B0, 0x6372, 0x6134, 0x60F6, 0x65B8, 0x647A, 0x663C, 0x67FE,
+    0x48C0, 0x4902, 0x4B44, 0x4A86, 0x4FC8, 0x4E0A, 0x4C4C, 0x4D8E,
+    0x46D0, 0x4712, 0x4554, 0x4496, 0x41D8, 0x401A, 0x425C, 0x439E,
+    0x54E0, 0x5522, 0x5764, 0x56A6, 0x53E8, 0x522A, 0x506C, 0x51AE,
+    0x5AF0, 0x5B32, 0x5974, 0x58B6, 0x5DF8, 0x5C3A, 0x5E7C, 0x5FBE,
+    0xE100, 0xE0C2, 0xE284, 0xE346, 0xE608, 0xE7CA, 0xE58C, 0xE44E,
+    0xEF10, 0xEED2, 0xEC94, 0xED56, 0xE818, 0xE9DA, 0xEB9C, 0xEA5E,
+    0xFD20, 0xFCE2, 0xFEA4, 0xFF66, 0xFA28, 0xFBEA, 0xF9AC, 0xF86E,
+    0xF330, 0xF2F2, 0xF0B4, 0xF176, 0xF438, 0xF5FA, 0xF7BC, 0xF67E,
+    0xD940, 0xD882, 0xDAC4, 0xDB06, 0xDE48, 0xDF8A, 0xDDCC, 0xDC0E,
+    0xD750, 0xD692, 0xD4D4, 0xD516, 0xD058, 0xD19A, 0xD3DC, 0xD21E,
+    0xC560, 0xC4A2, 0xC6E4, 0xC726, 0xC268, 0xC3AA, 0xC1EC, 0xC02E,
+    0xCB70, 0xCAB2, 0xC8F4, 0xC936, 0xCC78, 0xCDBA, 0xCFFC, 0xCE3E,
+    0x9180, 0x9042, 0x9204, 0x93C6, 0x9688, 0x974A, 0x950C, 0x94CE,
+    0x9F90, 0x9E52, 0x9C14, 0x9DD6, 0x9898, 0x995A, 0x9B1C, 0x9ADE,
+    0x8DA0, 0x8C62, 0x8E24, 0x8FE6, 0x8AA8, 0x8B6A, 0x892C, 0x88EE,
+    0x83B0, 0x8272, 0x8034, 0x81F6, 0x84B8, 0x857A, 0x873C, 0x86FE,
+    0xA9C0, 0xA802, 0xAA44, 0xAB86, 0xAEC8, 0xAF0A, 0xAD4C, 0xAC8E,
+    0xA7D0, 0xA612, 0xA454, 0xA596, 0xA0D8, 0xA11A, 0xA35C, 0xA29E,
+    0xB5E0, 0xB422, 0xB664, 0xB7A6, 0xB2E8, 0xB32A, 0xB16C, 0xB0AE,
+    0xBBF0, 0xBA32, 0xB874, 0xB9B6, 0xBCF8, 0xBD3A, 0xBF7C, 0xBEBE
+};
 
-  memcpy(result, Y, 16);
+// Multiplies V in host order by x, which is a shift right.
+static inline void shiftRight(uint32_t V[4])
+{
+    uint32_t mask = ((~(V[3] & 0x01)) + 1) & 0xE1000000;
+    V[3] = (V[3] >> 1) | (V[2] << 31);
+    V[2] = (V[2] >> 1) | (V[1] << 31);
+    V[1] = (V[1] >> 1) | (V[0] << 31);
+    V[0] = (V[0] >> 1) ^ mask;
 }
 
+// Fills M[i] with i * H, where the most significant bit of the index is
+// the lowest power of x.  Entry n / 2 is H, n / 4 is H * x and so on, and
+// every other entry is the XOR of the powers of two that make it up.
+static void initTable(uint32_t (*M)[4], uint16_t n, const void *key)
+{
+    GF128::mulInit(M[n / 2], key);
+    for (uint16_t i = n / 4; i > 0; i /= 2) {
+        memcpy(M[i], M[i * 2], 16);
+        shiftRight(M[i]);
+    }
+    memset(M[0], 0, 16);
+    for (uint16_t i = 2; i < n; i *= 2) {
+        for (uint16_t j = 1; j < i; ++j) {
+            M[i + j][0] = M[i][0] ^ M[j][0];
+            M[i + j][1] = M[i][1] ^ M[j][1];
+            M[i + j][2] = M[i][2] ^ M[j][2];
+            M[i + j][3] = M[i][3] ^ M[j][3];
+        }
+    }
+}
+
+#define MUL_STEP(bits, reduce, entry) \
+    do { \
+        uint32_t rem = Z3 & ((1 << (bits)) - 1); \
+        Z3 = (Z3 >> (bits)) | (Z2 << (32 - (bits))); \
+        Z2 = (Z2 >> (bits)) | (Z1 << (32 - (bits))); \
+        Z1 = (Z1 >> (bits)) | (Z0 << (32 - (bits))); \
+        Z0 = (Z0 >> (bits)) ^ (((uint32_t)pgm_read_word(&(reduce)[rem])) << 16); \
+        Z0 ^= (entry)[0]; \
+        Z1 ^= (entry)[1]; \
+        Z2 ^= (entry)[2]; \
+        Z3 ^= (entry)[3]; \
+    } while (0)
+
+/** @endcond */
+
+/**
+ * \brief Initializes a 16 entry table for mulTable4().
+ *
+ * \param M The 256 byte table to fill in.
+ * \param key Points to the 16 byte authentication key which is assumed
+ * to be in big-endian byte order.
+ *
+ * \sa mulTable4(), mulInitTable8()
+ */
+void GF128::mulInitTable4(uint32_t M[16][4], const void *key)
+{
+    initTable(M, 16, key);
+}
+
+/**
+ * \brief Perform a multiplication in the GF(2^128) field with Shoup's
+ * 4-bit table method.
+ *
+ * \param Y The first value to multiply, and the result.  This array is
+ * assumed to be in big-endian order on entry and exit.
+ * \param M The table of multiples of H from mulInitTable4().
+ *
+ * Y is consumed four bits at a time, most significant power of x first,
+ * with one table lookup and a shift per nibble.  The lookups are indexed
+ * by Y, so unlike mul() this is not constant time on processors with a
+ * data cache.
+ *
+ * \sa mulInitTable4(), mul()
+ */
+void GF128::mulTable4(uint32_t Y[4], const uint32_t M[16][4])
+{
+    const uint8_t *y = (const uint8_t *)Y;
+    const uint32_t *entry = M[y[15] & 0x0F];
+    uint32_t Z0 = entry[0];
+    uint32_t Z1 = entry[1];
+    uint32_t Z2 = entry[2];
+    uint32_t Z3 = entry[3];
+
+    MUL_STEP(4, reduce4, M[y[15] >> 4]);
+    for (int8_t posn = 14; posn >= 0; --posn) {
+        MUL_STEP(4, reduce4, M[y[posn] & 0x0F]);
+        MUL_STEP(4, reduce4, M[y[posn] >> 4]);
+    }
+
+    Y[0] = htobe32(Z0);
+    Y[1] = htobe32(Z1);
+    Y[2] = htobe32(Z2);
+    Y[3] = htobe32(Z3);
+}
+
+/**
+ * \brief Initializes a 256 entry table for mulTable8().
+ *
+ * \param M The 4096 byte table to fill in.
+ * \param key Points to the 16 byte authentication key which is assumed
+ * to be in big-endian byte order.
+ *
+ * \sa mulTable8(), mulInitTable4()
+ */
+void GF128::mulInitTable8(uint32_t M[256][4], const void *key)
+{
+    initTable(M, 256, key);
+}
+
+/**
+ * \brief Perform a multiplication in the GF(2^128) field with an 8-bit
+ * table.
+ *
+ * \param Y The first value to multiply, and the result.  This array is
+ * assumed to be in big-endian order on entry and exit.
+ * \param M The table of multiples of H from mulInitTable8().
+ *
+ * This halves the number of steps compared with mulTable4() at the cost
+ * of a 4K table per key, so it is only worth it on larger systems.
+ *
+ * \sa mulInitTable8(), mulTable4()
+ */
+void GF128::mulTable8(uint32_t Y[4], const uint32_t M[256][4])
+{
+    const uint8_t *y = (const uint8_t *)Y;
+    const uint32_t *entry = M[y[15]];
+    uint32_t Z0 = entry[0];
+    uint32_t Z1 = entry[1];
+    uint32_t Z2 = entry[2];
+    uint32_t Z3 = entry[3];
+
+    for (int8_t posn = 14; posn >= 0; --posn)
+        MUL_STEP(8, reduce8, M[y[posn]]);
+
+    Y[0] = htobe32(Z0);
+    Y[1] = htobe32(Z1);
+    Y[2] = htobe32(Z2);
+    Y[3] = htobe32(Z3);
+}
+
+#if defined(CRYPTO_GF128_CLMUL)
+
+/** @cond gf128_clmul */
+
+// The carry-less multiply code is written once against these operations
+// on 128-bit vectors, which map onto SSE/PCLMULQDQ or NEON/PMULL.
+// Values are kept byte reversed, so that a block read as a little-endian
+// 128-bit integer has the first byte of the block at the top.
+#if defined(__x86_64__)
+
+#define CLMUL_TARGET        __attribute__((target("pclmul,ssse3")))
+typedef __m128i clmul_t;
+#define CLMUL_LOAD(p)       _mm_loadu_si128((const __m128i *)(p))
+#define CLMUL_STORE(p, x)   _mm_storeu_si128((__m128i *)(p), (x))
+#define CLMUL_XOR(a, b)     _mm_xor_si128((a), (b))
+#define CLMUL_OR(a, b)      _mm_or_si128((a), (b))
+#define CLMUL_SHL32(x, n)   _mm_slli_epi32((x), (n))
+#define CLMUL_SHR32(x, n)   _mm_srli_epi32((x), (n))
+#define CLMUL_SHLB(x, n)    _mm_slli_si128((x), (n))
+#define CLMUL_SHRB(x, n)    _mm_srli_si128((x), (n))
+#define CLMUL_MUL_LL(a, b)  _mm_clmulepi64_si128((a), (b), 0x00)
+#define CLMUL_MUL_LH(a, b)  _mm_clmulepi64_si128((a), (b), 0x10)
+#define CLMUL_MUL_HL(a, b)  _mm_clmulepi64_si128((a), (b), 0x01)
+#define CLMUL_MUL_HH(a, b)  _mm_clmulepi64_si128((a), (b), 0x11)
+#define CLMUL_REVERSE(x) \
+    _mm_shuffle_epi8((x), _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, \
+                                       8, 9, 10, 11, 12, 13, 14, 15))
+
+#else // __aarch64__
+
+#ifndef HWCAP_PMULL
+#define HWCAP_PMULL (1 << 4)
+#endif
+
+#define CLMUL_TARGET        __attribute__((target("+crypto")))
+typedef uint8x16_t clmul_t;
+#define CLMUL_LOAD(p)       vld1q_u8((const uint8_t *)(p))
+#define CLMUL_STORE(p, x)   vst1q_u8((uint8_t *)(p), (x))
+#define CLMUL_XOR(a, b)     veorq_u8((a), (b))
+#define CLMUL_OR(a, b)      vorrq_u8((a), (b))
+#define CLMUL_SHL32(x, n) \
+    vreinterpretq_u8_u32(vshlq_n_u32(vreinterpretq_u32_u8(x), (n)))
+#define CLMUL_SHR32(x, n) \
+    vreinterpretq_u8_u32(vshrq_n_u32(vreinterpretq_u32_u8(x), (n)))
+#define CLMUL_SHLB(x, n)    vextq_u8(vdupq_n_u8(0), (x), 16 - (n))
+#define CLMUL_SHRB(x, n)    vextq_u8((x), vdupq_n_u8(0), (n))
+#define CLMUL_LANE(x, n)    vgetq_lane_p64(vreinterpretq_p64_u8(x), (n))
+#define CLMUL_PMULL(a, b)   vreinterpretq_u8_p128(vmull_p64((a), (b)))
+#define CLMUL_MUL_LL(a, b)  CLMUL_PMULL(CLMUL_LANE(a, 0), CLMUL_LANE(b, 0))
+#define CLMUL_MUL_LH(a, b)  CLMUL_PMULL(CLMUL_LANE(a, 0), CLMUL_LANE(b, 1))
+#define CLMUL_MUL_HL(a, b)  CLMUL_PMULL(CLMUL_LANE(a, 1), CLMUL_LANE(b, 0))
+#define CLMUL_MUL_HH(a, b)  CLMUL_PMULL(CLMUL_LANE(a, 1), CLMUL_LANE(b, 1))
+
+static inline CLMUL_TARGET clmul_t clmulReverse(clmul_t x)
+{
+    x = vrev64q_u8(x);
+    return vextq_u8(x, x, 8);
+}
+#define CLMUL_REVERSE(x)    clmulReverse(x)
+
+#endif
+
+// Adds the 256-bit carry-less product of a and b to lo:hi.
+static inline CLMUL_TARGET void clmulAccumulate
+    (clmul_t &lo, clmul_t &hi, clmul_t a, clmul_t b)
+{
+    clmul_t mid = CLMUL_XOR(CLMUL_MUL_LH(a, b), CLMUL_MUL_HL(a, b));
+    lo = CLMUL_XOR(lo, CLMUL_XOR(CLMUL_MUL_LL(a, b), CLMUL_SHLB(mid, 8)));
+    hi = CLMUL_XOR(hi, CLMUL_XOR(CLMUL_MUL_HH(a, b), CLMUL_SHRB(mid, 8)));
+}
+
+// Reduces lo:hi modulo the GCM polynomial.  The product of two bit
+// reflected values is one bit short, so it is shifted left first.  This
+// is algorithm 5 from Gueron and Kounavis, "Intel Carry-Less Multiplication
+// Instruction and its Usage for Computing the GCM Mode".  Because the
+// shift and the reduction are linear, several products can be summed and
+// then reduced once.
+static inline CLMUL_TARGET clmul_t clmulReduce(clmul_t lo, clmul_t hi)
+{
+    clmul_t t1, t2, t3;
+
+    t1 = CLMUL_SHR32(lo, 31);
+    t2 = CLMUL_SHR32(hi, 31);
+    lo = CLMUL_SHL32(lo, 1);
+    hi = CLMUL_SHL32(hi, 1);
+    t3 = CLMUL_SHRB(t1, 12);
+    t2 = CLMUL_SHLB(t2, 4);
+    t1 = CLMUL_SHLB(t1, 4);
+    lo = CLMUL_OR(lo, t1);
+    hi = CLMUL_OR(CLMUL_OR(hi, t2), t3);
+
+    t1 = CLMUL_XOR(CLMUL_XOR(CLMUL_SHL32(lo, 31), CLMUL_SHL32(lo, 30)),
+                   CLMUL_SHL32(lo, 25));
+    t2 = CLMUL_SHRB(t1, 4);
+    lo = CLMUL_XOR(lo, CLMUL_SHLB(t1, 12));
+
+    t1 = CLMUL_XOR(CLMUL_XOR(CLMUL_SHR32(lo, 1), CLMUL_SHR32(lo, 2)),
+                   CLMUL_SHR32(lo, 7));
+    lo = CLMUL_XOR(lo, CLMUL_XOR(t1, t2));
+    return CLMUL_XOR(hi, lo);
+}
+
+static inline CLMUL_TARGET clmul_t clmulMultiply(clmul_t a, clmul_t b)
+{
+    clmul_t lo = CLMUL_XOR(a, a);
+    clmul_t hi = lo;
+    clmulAccumulate(lo, hi, a, b);
+    return clmulReduce(lo, hi);
+}
+
+CLMUL_TARGET static void initCLMUL(uint32_t P[4][4], const void *key)
+{
+    clmul_t h = CLMUL_REVERSE(CLMUL_LOAD(key));
+    clmul_t power = h;
+    CLMUL_STORE(P[0], h);
+    for (uint8_t i = 1; i < 4; ++i) {
+        power = clmulMultiply(power, h);
+        CLMUL_STORE(P[i], power);
+    }
+}
+
+// Folds four blocks per reduction: Y = (Y + X1) H^4 + X2 H^3 + X3 H^2 + X4 H.
+CLMUL_TARGET static void ghashCLMUL(uint32_t Y[4], const uint32_t P[4][4],
+                                    const uint8_t *data, size_t blocks)
+{
+    clmul_t y = CLMUL_REVERSE(CLMUL_LOAD(Y));
+    clmul_t h1 = CLMUL_LOAD(P[0]);
+
+    if (blocks >= 4) {
+        clmul_t h2 = CLMUL_LOAD(P[1]);
+        clmul_t h3 = CLMUL_LOAD(P[2]);
+        clmul_t h4 = CLMUL_LOAD(P[3]);
+        do {
+            clmul_t lo = CLMUL_XOR(y, y);
+            clmul_t hi = lo;
+            clmul_t x = CLMUL_XOR(y, CLMUL_REVERSE(CLMUL_LOAD(data)));
+            clmulAccumulate(lo, hi, x, h4);
+            clmulAccumulate(lo, hi, CLMUL_REVERSE(CLMUL_LOAD(data + 16)), h3);
+            clmulAccumulate(lo, hi, CLMUL_REVERSE(CLMUL_LOAD(data + 32)), h2);
+            clmulAccumulate(lo, hi, CLMUL_REVERSE(CLMUL_LOAD(data + 48)), h1);
+            y = clmulReduce(lo, hi);
+            data += 64;
+            blocks -= 4;
+        } while (blocks >= 4);
+    }
+    while (blocks > 0) {
+        y = clmulMultiply(CLMUL_XOR(y, CLMUL_REVERSE(CLMUL_LOAD(data))), h1);
+        data += 16;
+        --blocks;
+    }
+
+    CLMUL_STORE(Y, CLMUL_REVERSE(y));
+}
+
+/** @endcond */
+
+/**
+ * \brief Determine if the CPU has a carry-less multiply instruction.
+ *
+ * \return Returns true if mulInitCLMUL() and mulCLMUL() can be used.
+ *
+ * This is only declared on x86-64 and 64-bit ARM Linux builds.
+ *
+ * \sa mulCLMUL()
+ */
+bool GF128::hasCLMUL()
+{
+    static int8_t supported = -1;
+    if (supported < 0) {
+#if defined(__x86_64__)
+        unsigned int eax, ebx, ecx, edx;
+        if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) &&
+                (ecx & bit_PCLMUL) != 0 && (ecx & bit_SSSE3) != 0)
+            supported = 1;
+        else
+            supported = 0;
+#else
+        supported = (getauxval(AT_HWCAP) & HWCAP_PMULL) ? 1 : 0;
+#endif
+    }
+    return supported != 0;
+}
+
+/**
+ * \brief Initializes the powers of H for mulCLMUL().
+ *
+ * \param P The H^1 to H^4 values to fill in.
+ * \param key Points to the 16 byte authentication key which is assumed
+ * to be in big-endian byte order.
+ *
+ * Must only be called if hasCLMUL() returns true.
+ *
+ * \sa mulCLMUL()
+ */
+void GF128::mulInitCLMUL(uint32_t P[4][4], const void *key)
+{
+    initCLMUL(P, key);
+}
+
+/**
+ * \brief Hashes whole blocks with the carry-less multiply instructions.
+ *
+ * \param Y The GHASH state, which is assumed to be in big-endian order on
+ * entry and exit.
+ * \param P The powers of H from mulInitCLMUL().
+ * \param data The blocks to hash.
+ * \param blocks The number of 16 byte blocks in \a data.
+ *
+ * For each block, Y is XOR'ed with the block and multiplied by H.  Runs
+ * of four blocks are multiplied by H^4 to H^1 and reduced once, which is
+ * the same value but about twice as fast as one block at a time.
+ *
+ * Must only be called if hasCLMUL() returns true.
+ *
+ * \sa mulInitCLMUL()
+ */
+void GF128::mulCLMUL(uint32_t Y[4], const uint32_t P[4][4],
+                     const void *data, size_t blocks)
+{
+    ghashCLMUL(Y, P, (const uint8_t *)data, blocks);
+}
+
+#endif // CRYPTO_GF128_CLMUL
+
 /**
  * \brief Doubles a value in the GF(2^128) field.
  *
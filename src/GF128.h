@@ -24,6 +24,16 @@
 #define CRYPTO_GF128_h
 
 #include <inttypes.h>
+#include <stddef.h>
+
+// 64-bit x86 and ARM Linux hosts multiply with the carry-less multiply
+// instructions (PCLMULQDQ, PMULL) when cpuid or the auxiliary vector say
+// the CPU has them.  Define CRYPTO_GF128_NO_CLMUL to always use the
+// portable code.
+#if defined(__GNUC__) && !defined(CRYPTO_GF128_NO_CLMUL) && \
+    (defined(__x86_64__) || (defined(__aarch64__) && defined(__linux__)))
+#define CRYPTO_GF128_CLMUL 1
+#endif
 
 class GF128
 {
@@ -34,6 +44,20 @@ private:
 public:
     static void mulInit(uint32_t H[4], const void *key);
     static void mul(uint32_t Y[4], const uint32_t H[4]);
+    static bool mulChip(uint32_t Y[4], const uint32_t H[4]);
+
+    static void mulInitTable4(uint32_t M[16][4], const void *key);
+    static void mulTable4(uint32_t Y[4], const uint32_t M[16][4]);
+    static void mulInitTable8(uint32_t M[256][4], const void *key);
+    static void mulTable8(uint32_t Y[4], const uint32_t M[256][4]);
+
+#if defined(CRYPTO_GF128_CLMUL)
+    static bool hasCLMUL();
+    static void mulInitCLMUL(uint32_t P[4][4], const void *key);
+    static void mulCLMUL(uint32_t Y[4], const uint32_t P[4][4],
+                         const void *data, size_t blocks);
+#endif
+
     static void dbl(uint32_t V[4]);
     static void dblEAX(uint32_t V[4]);
     static void dblXTS(uint32_t V[4]);
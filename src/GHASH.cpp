@@ -47,6 +47,8 @@
 GHASH::GHASH()
 {
     state.posn = 0;
+    state.chip = false;
+    state.failed = false;
 }
 
 /**
@@ -57,18 +59,69 @@ GHASH::~GHASH()
     clean(state);
 }
 
+/**
+ * \brief Selects whether the field multiplications run on the ATECC608.
+ *
+ * \param enable Set to true to send every 16 byte block to the chip's
+ * GFM command, or false for the software tables (the default).
+ *
+ * The chip round trip costs milliseconds per block, so this is only for
+ * applications that must not keep a table derived from the key in RAM.
+ * The setting survives reset() but not clear().  If the chip fails, the
+ * rest of the session is lost and finalize() reports it.
+ *
+ * \sa reset()
+ */
+void GHASH::useChip(bool enable)
+{
+    state.chip = enable;
+}
+
 /**
  * \brief Resets the GHASH message authenticator for a new session.
  *
  * \param key Points to the 16 byte authentication key.
  *
+ * This precomputes the table of multiples of \a key that update() uses.
+ *
  * \sa update(), finalize()
  */
 void GHASH::reset(const void *key)
 {
     GF128::mulInit(state.H, key);
+#if defined(CRYPTO_GF128_CLMUL)
+    if (GF128::hasCLMUL()) {
+        GF128::mulInitCLMUL(state.P, key);
+        memset(state.Y, 0, sizeof(state.Y));
+        state.posn = 0;
+        state.failed = false;
+        return;
+    }
+#endif
+#if defined(CRYPTO_GHASH_8BIT)
+    GF128::mulInitTable8(state.M, key);
+#else
+    GF128::mulInitTable4(state.M, key);
+#endif
     memset(state.Y, 0, sizeof(state.Y));
     state.posn = 0;
+    state.failed = false;
+}
+
+/**
+ * \brief Resets the GHASH message authenticator for a new session with
+ * the same key as last time.
+ *
+ * This skips recomputing the tables for the key, so it is much cheaper
+ * than reset(const void *) when many messages share a key.
+ *
+ * \sa reset(const void *)
+ */
+void GHASH::reset()
+{
+    memset(state.Y, 0, sizeof(state.Y));
+    state.posn = 0;
+    state.failed = false;
 }
 
 /**
@@ -86,6 +139,29 @@ void GHASH::update(const void *data, size_t len)
 {
     // XOR the input with state.Y in 128-bit chunks and process them.
     const uint8_t *d = (const uint8_t *)data;
+#if defined(CRYPTO_GF128_CLMUL)
+    if (state.posn == 0 && len >= 16 && !state.chip && GF128::hasCLMUL()) {
+        // Hand all of the whole blocks over at once so that they can be
+        // folded together.
+        size_t blocks = len / 16;
+        GF128::mulCLMUL(state.Y, state.P, d, blocks);
+        d += blocks * 16;
+        len -= blocks * 16;
+    }
+#endif
+    if (state.posn == 0) {
+        // Whole blocks can be XOR'ed in a word at a time.
+        while (len >= 16) {
+            for (uint8_t i = 0; i < 4; ++i) {
+                uint32_t word;
+                memcpy(&word, d + i * 4, 4);
+                state.Y[i] ^= word;
+            }
+            mul();
+            len -= 16;
+            d += 16;
+        }
+    }
     while (len > 0) {
         uint8_t size = 16 - state.posn;
         if (size > len)
@@ -97,7 +173,7 @@ void GHASH::update(const void *data, size_t len)
         len -= size;
         d += size;
         if (state.posn == 16) {
-            GF128::mul(state.Y, state.H);
+            mul();
             state.posn = 0;
         }
     }
@@ -108,6 +184,8 @@ void GHASH::update(const void *data, size_t len)
  *
  * \param token The buffer to return the token value in.
  * \param len The length of the \a token buffer between 0 and 16.
+ * \return Returns false if a multiplication on the chip failed since the
+ * last reset(), in which case \a token is zeroed.
  *
  * If \a len is less than 16, then the token value will be truncated to
  * the first \a len bytes.  If \a len is greater than 16, then the remaining
@@ -118,7 +196,7 @@ void GHASH::update(const void *data, size_t len)
  *
  * \sa reset(), update()
  */
-void GHASH::finalize(void *token, size_t len)
+bool GHASH::finalize(void *token, size_t len)
 {
     // Pad with zeroes to a multiple of 16 bytes.
     pad();
@@ -126,7 +204,12 @@ void GHASH::finalize(void *token, size_t len)
     // The token is the current value of Y.
     if (len > 16)
         len = 16;
+    if (state.failed) {
+        clean(token, len);
+        return false;
+    }
     memcpy(token, state.Y, len);
+    return true;
 }
 
 /**
@@ -139,7 +222,7 @@ void GHASH::pad()
     if (state.posn != 0) {
         // Padding involves XOR'ing the rest of state.Y with zeroes,
         // which does nothing.  Immediately process the next chunk.
-        GF128::mul(state.Y, state.H);
+        mul();
         state.posn = 0;
     }
 }
@@ -151,3 +234,29 @@ void GHASH::clear()
 {
     clean(state);
 }
+
+/**
+ * \brief Multiplies Y by the key.
+ */
+void GHASH::mul()
+{
+    if (state.chip) {
+        if (!GF128::mulChip(state.Y, state.H))
+            state.failed = true;
+        return;
+    }
+#if defined(CRYPTO_GF128_CLMUL)
+    if (GF128::hasCLMUL()) {
+        uint32_t X[4];
+        memcpy(X, state.Y, 16);
+        memset(state.Y, 0, 16);
+        GF128::mulCLMUL(state.Y, state.P, X, 1);
+        return;
+    }
+#endif
+#if defined(CRYPTO_GHASH_8BIT)
+    GF128::mulTable8(state.Y, state.M);
+#else
+    GF128::mulTable4(state.Y, state.M);
+#endif
+}
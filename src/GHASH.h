@@ -23,8 +23,18 @@
 #ifndef CRYPTO_GHASH_h
 #define CRYPTO_GHASH_h
 
-#include <inttypes.h>
-#include <stddef.h>
+#include "GF128.h"
+
+// GHASH multiplies with a 16 entry table of multiples of the key (256
+// bytes).  Define CRYPTO_GHASH_8BIT for a 256 entry table instead, which
+// takes 4K per object but halves the work per block.  Where GF128 has a
+// carry-less multiply backend and the CPU supports it, that is used
+// instead and the table is left empty.
+#if defined(CRYPTO_GHASH_8BIT)
+#define CRYPTO_GHASH_TABLE_SIZE 256
+#else
+#define CRYPTO_GHASH_TABLE_SIZE 16
+#endif
 
 class GHASH
 {
@@ -32,9 +42,12 @@ public:
     GHASH();
     ~GHASH();
 
+    void useChip(bool enable);
+
     void reset(const void *key);
+    void reset();
     void update(const void *data, size_t len);
-    void finalize(void *token, size_t len);
+    bool finalize(void *token, size_t len);
 
     void pad();
 
@@ -42,10 +55,18 @@ public:
 
 private:
     struct {
+        uint32_t M[CRYPTO_GHASH_TABLE_SIZE][4];
+#if defined(CRYPTO_GF128_CLMUL)
+        uint32_t P[4][4];
+#endif
         uint32_t H[4];
         uint32_t Y[4];
         uint8_t posn;
+        bool chip;
+        bool failed;
     } state;
+
+    void mul();
 };
 
 #endif
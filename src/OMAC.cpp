@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2026 Operator Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "OMAC.h"
+#include "GF128.h"
+#include "Crypto.h"
+#include <string.h>
+
+/**
+ * \class OMAC OMAC.h <OMAC.h>
+ * \brief Implementation of the OMAC message authenticator.
+ *
+ * OMAC1 is the message authentication code that NIST standardised as
+ * CMAC.  This class is a building block for other modes such as EAX:
+ * the caller owns the 16 byte hash state and can keep several of them
+ * going, one after the other, with the same OMAC object and key.  Only
+ * the encrypt direction of the block cipher is used.
+ *
+ * The block cipher must have a 16 byte block size and its key must be
+ * set before calling initKey().
+ *
+ * References: https://en.wikipedia.org/wiki/One-key_MAC,
+ * <a href="https://tools.ietf.org/html/rfc4493">RFC 4493</a>,
+ * http://web.cs.ucdavis.edu/~rogaway/papers/eax.html
+ *
+ * \sa EAX
+ */
+
+/**
+ * \brief Constructs a new OMAC object.
+ *
+ * This constructor must be followed by a call to setBlockCipher().
+ */
+OMAC::OMAC()
+    : _blockCipher(0)
+    , posn(0)
+{
+    memset(b, 0, sizeof(b));
+}
+
+/**
+ * \brief Destroys this OMAC object.
+ *
+ * \sa clear()
+ */
+OMAC::~OMAC()
+{
+    clean(b);
+}
+
+/**
+ * \fn BlockCipher *OMAC::blockCipher() const
+ * \brief Gets the block cipher that is in use for this OMAC object.
+ *
+ * \sa setBlockCipher()
+ */
+
+/**
+ * \fn void OMAC::setBlockCipher(BlockCipher *cipher)
+ * \brief Sets the block cipher to use for this OMAC object.
+ *
+ * \param cipher The block cipher to use to implement OMAC.
+ * This object must have a block size of 128 bits (16 bytes).
+ *
+ * \sa blockCipher()
+ */
+
+/**
+ * \brief Derives the subkey from the block cipher's current key.
+ *
+ * This must be called after every change to the block cipher's key and
+ * before init().  It costs one block encryption, which is then shared
+ * by every message under that key.
+ */
+void OMAC::initKey()
+{
+    // B = 2 * E(K, 0).  The padding value P = 2 * B is computed from it
+    // when it is needed in finalize().
+    memset(b, 0, sizeof(b));
+    _blockCipher->encryptBlock((uint8_t *)b, (uint8_t *)b);
+    GF128::dblEAX(b);
+}
+
+/**
+ * \brief Starts a plain OMAC (CMAC) hash.
+ *
+ * \param omac The OMAC hash state.
+ *
+ * \sa update(), finalize()
+ */
+void OMAC::init(uint32_t omac[4])
+{
+    memset(omac, 0, 16);
+    posn = 0;
+}
+
+/**
+ * \brief Starts an OMAC hash that is prefixed with a tag block.
+ *
+ * \param omac The OMAC hash state.
+ * \param tag The tag value, which is placed in the last byte of a block
+ * of zeroes ahead of the data.  EAX uses 0 for the nonce, 1 for the
+ * authenticated data and 2 for the ciphertext.
+ *
+ * \sa update(), finalize()
+ */
+void OMAC::init(uint32_t omac[4], uint8_t tag)
+{
+    // The tag block is full, so it is encrypted when the first data
+    // arrives or is XOR'ed with B if there is no data at all.
+    memset(omac, 0, 15);
+    ((uint8_t *)omac)[15] = tag;
+    posn = 16;
+}
+
+/**
+ * \brief Updates an OMAC hash with more data.
+ *
+ * \param omac The OMAC hash state.
+ * \param data The data to add to the hash.
+ * \param size The size of the data to add to the hash.
+ *
+ * \sa init(), finalize()
+ */
+void OMAC::update(uint32_t omac[4], const uint8_t *data, size_t size)
+{
+    while (size > 0) {
+        // Encrypt the current block if it is already full.
+        if (posn == 16) {
+            _blockCipher->encryptBlock((uint8_t *)omac, (uint8_t *)omac);
+            posn = 0;
+        }
+
+        // XOR the incoming data with the current block.
+        uint8_t len = 16 - posn;
+        if (len > size)
+            len = (uint8_t)size;
+        uint8_t *o = ((uint8_t *)omac) + posn;
+        for (uint8_t index = 0; index < len; ++index)
+            o[index] ^= data[index];
+        posn += len;
+        data += len;
+        size -= len;
+    }
+}
+
+/**
+ * \brief Finalizes an OMAC hash.
+ *
+ * \param omac The OMAC hash state, which contains the final hash on exit.
+ *
+ * \sa init(), update()
+ */
+void OMAC::finalize(uint32_t omac[4])
+{
+    uint32_t p[4];
+    memcpy(p, b, sizeof(p));
+    if (posn != 16) {
+        // Pad the partial block and XOR with P = 2 * B.
+        ((uint8_t *)omac)[posn] ^= 0x80;
+        GF128::dblEAX(p);
+    }
+    omac[0] ^= p[0];
+    omac[1] ^= p[1];
+    omac[2] ^= p[2];
+    omac[3] ^= p[3];
+    _blockCipher->encryptBlock((uint8_t *)omac, (uint8_t *)omac);
+    clean(p);
+}
+
+/**
+ * \brief Clears all security-sensitive state from this object.
+ */
+void OMAC::clear()
+{
+    clean(b);
+    posn = 0;
+}
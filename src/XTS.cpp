@@ -0,0 +1,460 @@
+/*
+ * Copyright (C) 2026 Operator Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "XTS.h"
+#include "Crypto.h"
+#include "ECCX08.h"
+#include "GF128.h"
+#include <string.h>
+
+/**
+ * \class XTSCommon XTS.h <XTS.h>
+ * \brief Concrete base class to assist with implementing XTS mode for
+ * 128-bit block ciphers.
+ *
+ * XTS encrypts fixed-size sectors of a storage device.  Each sector is
+ * encrypted under a tweak, normally the sector number, so that equal
+ * plaintext in different sectors gives different ciphertext and the
+ * ciphertext is exactly the same size as the plaintext.  Sector sizes
+ * that are not a multiple of 16 are handled with ciphertext stealing.
+ *
+ * Two keys are needed: one for the data and one to encrypt the tweak.
+ * They can be given in software with setKey(), or be held in slots of
+ * the ATECC608 with setKeySlots().
+ *
+ * Whole blocks are processed four at a time: the tweaks for the next
+ * four blocks are computed with GF128::dblXTS() and the block cipher is
+ * then called once for all of them, which lets the multi-block AES
+ * backends run at full speed.
+ *
+ * References: <a href="http://libeccio.di.unisa.it/Crypto14/Lab/p1619.pdf">IEEE Std. 1619-2007, XTS-AES</a>
+ *
+ * \sa XTS
+ */
+
+/**
+ * \brief Constructs an XTS object with a default sector size of 512 bytes.
+ *
+ * This constructor must be followed by a call to setBlockCiphers().
+ */
+XTSCommon::XTSCommon()
+    : blockCipher1(0)
+    , blockCipher2(0)
+    , sectSize(512)
+    , slot1(-1)
+    , slot2(-1)
+    , tweakPending(false)
+{
+    memset(twk, 0, sizeof(twk));
+}
+
+/**
+ * \brief Clears all sensitive information and destroys this object.
+ */
+XTSCommon::~XTSCommon()
+{
+    clean(twk);
+}
+
+/**
+ * \brief Returns the size of the key in bytes.
+ *
+ * The key is the concatenation of the data key and the tweak key, so
+ * for AES128 this returns 32.
+ *
+ * \sa setKey(), tweakSize()
+ */
+size_t XTSCommon::keySize() const
+{
+    return blockCipher1->keySize() + blockCipher2->keySize();
+}
+
+/**
+ * \brief Returns the maximum size of the tweak in bytes.
+ *
+ * \sa setTweak(), keySize()
+ */
+size_t XTSCommon::tweakSize() const
+{
+    return 16;
+}
+
+/**
+ * \brief Sets the size of sectors encrypted or decrypted by this object.
+ *
+ * \param size The sector size in bytes, which must be at least 16.
+ * \return Returns false if \a size is less than 16.
+ *
+ * \sa sectorSize(), encryptSector()
+ */
+bool XTSCommon::setSectorSize(size_t size)
+{
+    if (size < 16)
+        return false;
+    sectSize = size;
+    return true;
+}
+
+/**
+ * \brief Sets the key to use for XTS mode.
+ *
+ * \param key Points to the key, which is the data key followed by the
+ * tweak key.
+ * \param len The length of the key in bytes, which must be keySize().
+ * \return Returns false if the key length is not supported.
+ *
+ * This switches back to software keys if setKeySlots() was in use.
+ *
+ * \sa keySize(), setKeySlots(), setTweak()
+ */
+bool XTSCommon::setKey(const uint8_t *key, size_t len)
+{
+    size_t len1 = blockCipher1->keySize();
+    if (len != len1 + blockCipher2->keySize())
+        return false;
+    slot1 = -1;
+    slot2 = -1;
+    if (!blockCipher1->setKey(key, len1))
+        return false;
+    return blockCipher2->setKey(key + len1, len - len1);
+}
+
+/**
+ * \brief Uses keys in slots of the ATECC608 instead of software keys.
+ *
+ * \param slot The slot holding the data key, or -1 to use the data key
+ * that was last given to setKey().
+ * \param tweakSlot The slot holding the tweak key, or -1 to use the tweak
+ * key that was last given to setKey().
+ *
+ * The two slots should hold different keys.  Every block of a sector is
+ * then one AES command on the chip, plus one for the tweak.  The tweak is
+ * encrypted at the start of the next sector, so that the whole sector
+ * takes a single wake of the chip.
+ *
+ * \sa setKey()
+ */
+void XTSCommon::setKeySlots(int slot, int tweakSlot)
+{
+    slot1 = slot;
+    slot2 = tweakSlot;
+}
+
+/**
+ * \brief Sets the tweak value for the current sector to encrypt or decrypt.
+ *
+ * \param tweak Points to the tweak, usually the sector number in
+ * little-endian byte order.
+ * \param len The length of the tweak, at most tweakSize().  Shorter
+ * tweaks are padded with zeroes.
+ * \return Returns false if \a len is greater than tweakSize(), or if the
+ * tweak key lives on the chip inside the block cipher and the chip failed.
+ * In that case the next sector tries again to encrypt the tweak.
+ *
+ * The key must be set before calling this function, and the tweak must
+ * be set again before each sector.
+ *
+ * \sa encryptSector(), decryptSector()
+ */
+bool XTSCommon::setTweak(const uint8_t *tweak, size_t len)
+{
+    if (len > 16)
+        return false;
+    memcpy(twk, tweak, len);
+    memset(((uint8_t *)twk) + len, 0, 16 - len);
+    tweakPending = true;
+    if (slot2 >= 0)
+        return true;
+
+    // A software tweak key is used straight away, but the block cipher
+    // may still keep its own key in a slot of the chip.
+    uint32_t t[4];
+    bool ok = startSector(t);
+    clean(t);
+    return ok;
+}
+
+/**
+ * \brief Encrypts an entire sector of data.
+ *
+ * \param output The output buffer to write the ciphertext to, which can
+ * be the same as \a input.
+ * \param input The input buffer to read the plaintext from.
+ * \return Returns false if the chip failed, in which case \a output is
+ * zeroed.
+ *
+ * The \a input and \a output buffers must be at least sectorSize()
+ * bytes in length.
+ *
+ * \sa decryptSector(), setTweak(), setSectorSize()
+ */
+bool XTSCommon::encryptSector(uint8_t *output, const uint8_t *input)
+{
+    size_t sectLast = sectSize & ~((size_t)15);
+    uint32_t t[4];
+    bool chip = (slot1 >= 0 || slot2 >= 0);
+    if (chip)
+        ECCX08.beginSession();
+    bool ok = startSector(t) && cryptBlocks(output, input, sectLast / 16, t, false);
+    if (ok && sectSize > sectLast) {
+        // Ciphertext stealing: the last whole block of ciphertext gives
+        // its first bytes to the final partial block and is replaced by
+        // the encryption of the partial plaintext padded with the rest.
+        uint8_t block[16];
+        size_t leftOver = sectSize - sectLast;
+        output += sectLast;
+        input += sectLast;
+        memcpy(block, output - 16, 16);
+        memcpy(block, input, leftOver);
+        memcpy(output, output - 16, leftOver);
+        ok = cryptBlock(output - 16, block, t, false);
+        output -= sectLast;
+        clean(block);
+    }
+    return finishSector(output, t, chip, ok);
+}
+
+/**
+ * \brief Decrypts an entire sector of data.
+ *
+ * \param output The output buffer to write the plaintext to, which can
+ * be the same as \a input.
+ * \param input The input buffer to read the ciphertext from.
+ * \return Returns false if the chip failed, in which case \a output is
+ * zeroed.
+ *
+ * The \a input and \a output buffers must be at least sectorSize()
+ * bytes in length.
+ *
+ * \sa encryptSector(), setTweak(), setSectorSize()
+ */
+bool XTSCommon::decryptSector(uint8_t *output, const uint8_t *input)
+{
+    size_t sectLast = sectSize & ~((size_t)15);
+    uint32_t t[4];
+    bool chip = (slot1 >= 0 || slot2 >= 0);
+    if (chip)
+        ECCX08.beginSession();
+    bool ok = startSector(t);
+    if (ok && sectSize > sectLast) {
+        // The last whole block was encrypted with the tweak after its
+        // own, so hold it back and undo the ciphertext stealing.
+        uint8_t block[16];
+        uint32_t t2[4];
+        size_t leftOver = sectSize - sectLast;
+        ok = cryptBlocks(output, input, sectLast / 16 - 1, t, true);
+        output += sectLast - 16;
+        input += sectLast - 16;
+        memcpy(t2, t, sizeof(t));
+        GF128::dblXTS(t2);
+        ok = ok && cryptBlock(block, input, t2, true);
+        for (size_t posn = 0; posn < leftOver; ++posn) {
+            // Swap byte by byte in case we are decrypting in place.
+            uint8_t c = input[16 + posn];
+            output[16 + posn] = block[posn];
+            block[posn] = c;
+        }
+        ok = ok && cryptBlock(output, block, t, true);
+        output -= sectLast - 16;
+        clean(block);
+        clean(t2);
+    } else if (ok) {
+        ok = cryptBlocks(output, input, sectLast / 16, t, true);
+    }
+    return finishSector(output, t, chip, ok);
+}
+
+/**
+ * \brief Clears all security-sensitive state from this XTS object.
+ */
+void XTSCommon::clear()
+{
+    clean(twk);
+    blockCipher1->clear();
+    blockCipher2->clear();
+    slot1 = -1;
+    slot2 = -1;
+    tweakPending = false;
+}
+
+/**
+ * \brief Gets the encrypted tweak for the first block of a sector.
+ *
+ * \param tweak Returns the tweak.
+ * \return Returns false if the chip failed to encrypt it.
+ *
+ * A tweak that setTweak() left for the chip is encrypted here with the
+ * current tweak key, inside the sector's session, and kept so that the
+ * sector can be redone.  On failure it stays pending for the next try.
+ */
+bool XTSCommon::startSector(uint32_t tweak[4])
+{
+    if (!tweakPending) {
+        memcpy(tweak, twk, 16);
+        return true;
+    }
+    bool ok;
+    if (slot2 < 0)
+        ok = blockCipher2->encryptBlocks((uint8_t *)tweak, (const uint8_t *)twk, 1);
+    else
+        ok = blockCipher2->encryptBlocksWithSlot(slot2, (uint8_t *)tweak, (const uint8_t *)twk, 1);
+    if (!ok)
+        return false;
+    memcpy(twk, tweak, 16);
+    tweakPending = false;
+    return true;
+}
+
+/**
+ * \brief Ends the chip session of a sector, if any, and zeroes the
+ * \a output sector if \a ok is false.
+ */
+bool XTSCommon::finishSector(uint8_t *output, uint32_t tweak[4], bool chip, bool ok)
+{
+    if (chip)
+        ECCX08.endSession();
+    if (!ok)
+        clean(output, sectSize);
+    clean(tweak, 16);
+    return ok;
+}
+
+/**
+ * \brief Encrypts or decrypts a single block with the data key.
+ *
+ * \param output The output block, which may be the same as \a input.
+ * \param input The input block.
+ * \param tweak The tweak for this block.
+ * \param decrypt True to decrypt rather than encrypt.
+ * \return Returns false if the chip failed.
+ */
+bool XTSCommon::cryptBlock(uint8_t *output, const uint8_t *input,
+                           const uint32_t tweak[4], bool decrypt)
+{
+    const uint8_t *t = (const uint8_t *)tweak;
+    uint8_t block[16];
+    bool ok = true;
+    for (uint8_t posn = 0; posn < 16; ++posn)
+        block[posn] = input[posn] ^ t[posn];
+    if (slot1 >= 0) {
+        if (decrypt)
+            ok = blockCipher1->decryptBlocksWithSlot(slot1, block, block, 1);
+        else
+            ok = blockCipher1->encryptBlocksWithSlot(slot1, block, block, 1);
+    } else if (decrypt) {
+        ok = blockCipher1->decryptBlocks(block, block, 1);
+    } else {
+        ok = blockCipher1->encryptBlocks(block, block, 1);
+    }
+    for (uint8_t posn = 0; posn < 16; ++posn)
+        output[posn] = block[posn] ^ t[posn];
+    clean(block);
+    return ok;
+}
+
+/**
+ * \brief Encrypts or decrypts whole blocks with the data key.
+ *
+ * \param output The output buffer, which may be the same as \a input.
+ * \param input The input buffer.
+ * \param blocks The number of 16 byte blocks to process.
+ * \param tweak The tweak for the first block on entry, and the tweak for
+ * the block after the last on exit.
+ * \param decrypt True to decrypt rather than encrypt.
+ * \return Returns false if the chip failed.
+ *
+ * Up to four blocks are done per call to the block cipher, or per batch
+ * of chip commands with a key slot.  The XOR's with the tweak are done a
+ * word at a time; memcpy() keeps the accesses to \a input and \a output
+ * safe if they are not aligned.
+ */
+bool XTSCommon::cryptBlocks(uint8_t *output, const uint8_t *input, size_t blocks,
+                            uint32_t tweak[4], bool decrypt)
+{
+    uint32_t t[16];
+    uint32_t buf[16];
+    uint8_t *b = (uint8_t *)buf;
+    bool ok = true;
+    while (ok && blocks > 0) {
+        uint8_t count = (blocks < 4) ? blocks : 4;
+        uint8_t words = count * 4;
+        uint8_t posn;
+
+        // Compute the tweaks for this group of blocks.
+        for (posn = 0; posn < words; posn += 4) {
+            memcpy(t + posn, tweak, 16);
+            GF128::dblXTS(tweak);
+        }
+
+        // XOR with the tweaks, run the block cipher, XOR again.
+        for (posn = 0; posn < words; ++posn) {
+            uint32_t word;
+            memcpy(&word, input + posn * 4, 4);
+            buf[posn] = word ^ t[posn];
+        }
+        if (slot1 >= 0) {
+            if (decrypt)
+                ok = blockCipher1->decryptBlocksWithSlot(slot1, b, b, count);
+            else
+                ok = blockCipher1->encryptBlocksWithSlot(slot1, b, b, count);
+        } else if (decrypt) {
+            ok = blockCipher1->decryptBlocks(b, b, count);
+        } else {
+            ok = blockCipher1->encryptBlocks(b, b, count);
+        }
+        for (posn = 0; posn < words; ++posn) {
+            uint32_t word = buf[posn] ^ t[posn];
+            memcpy(output + posn * 4, &word, 4);
+        }
+
+        input += count * 16;
+        output += count * 16;
+        blocks -= count;
+    }
+    clean(t);
+    clean(buf);
+    return ok;
+}
+
+/**
+ * \class XTS XTS.h <XTS.h>
+ * \brief Implementation of the XTS mode for 128-bit block ciphers.
+ *
+ * The template parameter T1 is the block cipher for the data and T2 is
+ * the block cipher for the tweak, which is normally the same as T1.
+ * Both must have a block size of 16 bytes (128 bits).
+ *
+ * \code
+ * XTS<AES128> xts;
+ * xts.setKey(key, 32);
+ * xts.setSectorSize(256);
+ * xts.setTweak(sectorNumber, sizeof(sectorNumber));
+ * xts.encryptSector(output, input);
+ * \endcode
+ *
+ * \sa XTSCommon
+ */
+
+/**
+ * \fn XTS::XTS()
+ * \brief Constructs an object for encrypting sectors in XTS mode.
+ */
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2026 Operator Foundation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CRYPTO_XTS_h
+#define CRYPTO_XTS_h
+
+#include "BlockCipher.h"
+
+class XTSCommon
+{
+public:
+    virtual ~XTSCommon();
+
+    size_t keySize() const;
+    size_t tweakSize() const;
+
+    size_t sectorSize() const { return sectSize; }
+    bool setSectorSize(size_t size);
+
+    bool setKey(const uint8_t *key, size_t len);
+    void setKeySlots(int slot, int tweakSlot);
+    bool setTweak(const uint8_t *tweak, size_t len);
+
+    bool encryptSector(uint8_t *output, const uint8_t *input);
+    bool decryptSector(uint8_t *output, const uint8_t *input);
+
+    void clear();
+
+protected:
+    XTSCommon();
+    void setBlockCiphers(BlockCipher *cipher1, BlockCipher *cipher2)
+    {
+        blockCipher1 = cipher1;
+        blockCipher2 = cipher2;
+    }
+
+private:
+    BlockCipher *blockCipher1;
+    BlockCipher *blockCipher2;
+    uint32_t twk[4];
+    size_t sectSize;
+    int8_t slot1;
+    int8_t slot2;
+    bool tweakPending;
+
+    bool startSector(uint32_t tweak[4]);
+    bool finishSector(uint8_t *output, uint32_t tweak[4], bool chip, bool ok);
+    bool cryptBlock(uint8_t *output, const uint8_t *input,
+                    const uint32_t tweak[4], bool decrypt);
+    bool cryptBlocks(uint8_t *output, const uint8_t *input, size_t blocks,
+                     uint32_t tweak[4], bool decrypt);
+};
+
+template <typename T1, typename T2 = T1>
+class XTS : public XTSCommon
+{
+public:
+    XTS() { setBlockCiphers(&cipher1, &cipher2); }
+
+private:
+    T1 cipher1;
+    T2 cipher2;
+};
+
+#endif